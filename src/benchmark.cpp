@@ -0,0 +1,211 @@
+/*
+ * Benchmark harness: renders the scene off-screen for a fixed number of
+ * frames, with a fixed random seed and scripted input, and reports where
+ * the time went.
+ */
+
+#include "cs432.h"
+#include "mat.h"
+#include "benchmark.h"
+#include "profiler.h"
+#include "frameClock.h"
+#include "game.h"
+#include "scene.h"
+#include "jobs.h"
+#include "glState.h"
+#include "headless.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+// simulation step per frame, as in the interactive program
+static const double STEP = 0.050;
+
+// number of timer queries in flight; results are read this many frames late
+// so that reading them never waits for the GPU
+static const int NUM_QUERIES = 4;
+
+// the phases of a frame that we time
+enum Phase { SIMULATION, MATRICES, UPLOAD, DRAW, GPU, NUM_PHASES };
+static const char* phaseNames[NUM_PHASES] = {
+    "simulation", "matrix_math", "uniform_upload", "draw_submission", "gpu"
+};
+
+// per-frame times (in seconds) for one phase
+class PhaseTimes {
+    std::vector<double> _samples;
+public:
+    void add(double t) { _samples.push_back(t); }
+    bool empty() const { return _samples.empty(); }
+
+    double total() const {
+        double sum = 0;
+        for (size_t i = 0; i < _samples.size(); i++) sum += _samples[i];
+        return sum;
+    }
+
+    // the given percentile, from a sorted copy of the samples
+    double percentile(double fraction) const {
+        if (_samples.empty()) return 0;
+        std::vector<double> sorted(_samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t idx = (size_t)(fraction * (sorted.size() - 1));
+        return sorted[idx];
+    }
+};
+
+// the scripted input for a frame: regular clicks on the dice and on
+// "Hold", and a camera that turns and moves in a cycle that returns it to
+// where it started (taking the scoreboard out of view part of the time)
+static void scriptedInput(int frame, GameState& game, mat4& camera) {
+    if (frame % 60 == 0) {
+        gameRoll(game);
+    }
+    if (frame % 150 == 75) {
+        gameHold(game);
+    }
+    switch ((frame / 60) % 4) {
+    case 0: camera = RotateY(1.5) * camera; break;           // 'd'
+    case 1: camera = Translate(0, 0, -0.1) * camera; break;  // 's'
+    case 2: camera = RotateY(-1.5) * camera; break;          // 'a'
+    case 3: camera = Translate(0, 0, 0.1) * camera; break;   // 'w'
+    }
+}
+
+// write one phase as a JSON object, in milliseconds
+static void writePhase(FILE* fp, const char* name, const PhaseTimes& t,
+                       int frames, bool last) {
+    fprintf(fp, "    \"%s\": { \"total_ms\": %.3f, \"mean_ms\": %.4f, "
+                "\"p50_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+            name, t.total() * 1000, frames > 0 ? t.total() * 1000 / frames : 0,
+            t.percentile(0.50) * 1000, t.percentile(0.99) * 1000,
+            t.percentile(1.0) * 1000, last ? "" : ",");
+}
+
+int runBenchmark(const BenchmarkOptions& options) {
+    if (!headlessCreateContext(options.width, options.height)) {
+        return 1;
+    }
+
+    // the same seed always gives the same rolls
+    GameState game;
+    gameInit(game, options.seed);
+    mat4 camera = LookAt(0, 1, 2.5, 0, 1, -5, 0, 1, 0);
+
+    sceneInit();
+    sceneResize(options.width, options.height);
+
+    // GPU timing needs timer queries (OpenGL 3.3)
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool gpuTiming = major > 3 || (major == 3 && minor >= 3);
+    GLuint queries[NUM_QUERIES];
+    if (gpuTiming) glGenQueries(NUM_QUERIES, queries);
+
+    PhaseTimes times[NUM_PHASES];
+    std::vector<DrawItem> items;
+    CullStats cullStats = { 0, 0 };
+    double vertices = 0; // drawn, after culling and level-of-detail choices
+
+    // warm up: draw one frame outside the measurements, so that one-time
+    // costs (shader compilation in the driver, first use of a timer query)
+    // are not counted
+    sceneBuild(gameSnapshot(game), camera, items);
+    for (int i = 0; gpuTiming && i < NUM_QUERIES; i++) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[i]);
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+    sceneSubmit(gameSnapshot(game), camera, items);
+    glFinish();
+
+    double start = clockNow();
+    stateResetCounters();
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        int slot = frame % NUM_QUERIES;
+        if (gpuTiming && frame >= NUM_QUERIES) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &ns);
+            times[GPU].add(ns * 1e-9);
+        }
+
+        double t0 = clockNow();
+        scriptedInput(frame, game, camera);
+        gameUpdate(game, STEP);
+        GameSnapshot snap = gameSnapshot(game);
+
+        double t1 = clockNow();
+        sceneBuild(snap, camera, items, &cullStats);
+        for (size_t i = 0; i < items.size(); i++) vertices += items[i].count;
+
+        double t2 = clockNow();
+        if (gpuTiming) glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+        SubmitTimes submit = { 0, 0 };
+        sceneSubmit(snap, camera, items, &submit);
+        if (gpuTiming) glEndQuery(GL_TIME_ELAPSED);
+
+        times[SIMULATION].add(t1 - t0);
+        times[MATRICES].add(t2 - t1);
+        times[UPLOAD].add(submit.upload);
+        times[DRAW].add(submit.draw);
+        PROFILE_FRAME();
+    }
+
+    // collect the queries still in flight
+    if (gpuTiming) {
+        int first = options.frames > NUM_QUERIES ? options.frames - NUM_QUERIES : 0;
+        for (int frame = first; frame < options.frames; frame++) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[frame % NUM_QUERIES], GL_QUERY_RESULT, &ns);
+            times[GPU].add(ns * 1e-9);
+        }
+        glDeleteQueries(NUM_QUERIES, queries);
+    }
+    glFinish();
+    double wall = clockNow() - start;
+
+    FILE* fp = stdout;
+    if (options.jsonFile != NULL) {
+        fopen_s(&fp, options.jsonFile, "w");
+        if (fp == NULL) {
+            std::cerr << "could not write " << options.jsonFile << std::endl;
+            headlessDestroyContext();
+            return 1;
+        }
+    }
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"frames\": %d,\n", options.frames);
+    fprintf(fp, "  \"seed\": %llu,\n", (unsigned long long)options.seed);
+    fprintf(fp, "  \"width\": %d,\n", options.width);
+    fprintf(fp, "  \"height\": %d,\n", options.height);
+    fprintf(fp, "  \"threads\": %d,\n", jobsWorkers() + 1);
+    fprintf(fp, "  \"renderer\": \"%s\",\n", (const char*)glGetString(GL_RENDERER));
+    fprintf(fp, "  \"wall_seconds\": %.6f,\n", wall);
+    fprintf(fp, "  \"frames_per_second\": %.2f,\n", wall > 0 ? options.frames / wall : 0);
+    fprintf(fp, "  \"final_score\": [%d, %d],\n", game.myScore, game.AIScore);
+    fprintf(fp, "  \"culling\": { \"objects_per_frame\": %.2f, \"culled_per_frame\": %.2f },\n",
+            (double)cullStats.tested / options.frames, (double)cullStats.culled / options.frames);
+    fprintf(fp, "  \"vertices_per_frame\": %.1f,\n", vertices / options.frames);
+    const StateCounters& state = stateCounters();
+    fprintf(fp, "  \"state_calls_per_frame\": {\n");
+    for (int c = 0; c < NUM_STATE_CALLS; c++) {
+        fprintf(fp, "    \"%s\": { \"issued\": %.2f, \"skipped\": %.2f }%s\n",
+                stateCallName(c), (double)state.issued[c] / options.frames,
+                (double)state.skipped[c] / options.frames,
+                c == NUM_STATE_CALLS - 1 ? "" : ",");
+    }
+    fprintf(fp, "  },\n");
+    fprintf(fp, "  \"phases\": {\n");
+    int lastPhase = gpuTiming ? GPU : DRAW;
+    for (int p = 0; p <= lastPhase; p++) {
+        writePhase(fp, phaseNames[p], times[p], options.frames, p == lastPhase);
+    }
+    fprintf(fp, "  }\n");
+    fprintf(fp, "}\n");
+    if (fp != stdout) fclose(fp);
+
+    headlessDestroyContext();
+    return 0;
+}
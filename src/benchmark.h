@@ -0,0 +1,26 @@
+/*
+ * Benchmark harness: renders the scene off-screen for a fixed number of
+ * frames, with a fixed random seed and scripted input, and reports where
+ * the time went.
+ *
+ * Every run with the same options performs exactly the same work, so the
+ * numbers can be compared between builds.
+ */
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdint.h>
+
+struct BenchmarkOptions {
+    int frames;           // number of frames to render
+    uint64_t seed;        // seed for the game's random numbers (as --seed)
+    int width;            // size of the off-screen framebuffer
+    int height;
+    const char* jsonFile; // where to write the JSON report (NULL: stdout)
+};
+
+// run the benchmark; returns the process exit status
+int runBenchmark(const BenchmarkOptions& options);
+
+#endif
@@ -644,26 +644,28 @@ static CoordList characterCoords[] = {
               ),
 };
 
+// how many vertices genPolyhedron6 generates: 6 faces of 2 triangles each
+static const int POLYHEDRON_VERTICES = 6 * 2 * 3;
+
+// how many pieces an arc is divided into; at least one, so that short
+// arcs do not vanish at coarse levels of detail
+static int arcSegments(double startAngle, double endAngle, double divCircle) {
+    if (startAngle >= endAngle) return 0;
+    if (divCircle <= 0) divCircle = 1;
+    int count = (int)(divCircle*(endAngle-startAngle));
+    return count > 0 ? count : 1;
+}
+
 static void genPoint(double x, double y, double z, vec4 theColor, GLfloat shininess, vec3 normal,
-                     int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                     vec4 *color2Array , vec4 *color3Array , GLfloat *shininessArray) {
-    // add the first point to the array
-    if (idxVar[0] < idxVar[1]) {
-        pointsArray[*idxVar] = vec4(x, y, z, 1.0);
-        color1Array[*idxVar] = theColor;
-        if (normalsArray != NULL) normalsArray[*idxVar] = normal;
-        if (color2Array != NULL) color2Array[*idxVar] = theColor;
-        if (color3Array != NULL) color3Array[*idxVar] = theColor;
-        if (shininessArray != NULL) shininessArray[*idxVar] = shininess;
-    }
-    idxVar[0]++;
+                     Mesh& mesh) {
+    // add the point to the mesh
+    mesh.add(vec4(x, y, z, 1.0), normal, theColor, shininess);
 }
 
 static void genPolyhedron6(double x1, double y1, double x2, double y2,
                            double x3, double y3, double x4, double y4, double dz, vec4 theColor,
                            GLfloat shininess,
-                           int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                           vec4 *color2Array, vec4 *color3Array, GLfloat *shininessArray) {
+                           Mesh& mesh) {
     // **** here is a picture ****
     //   (x1,y1)
     //       *
@@ -679,23 +681,17 @@ static void genPolyhedron6(double x1, double y1, double x2, double y2,
 #endif
     // generate vertices for front face
     vec3 normal = -normalize(cross(vec3(x2-x1,y2-y1,0),vec3(x4-x2,y4-y2,0)));
-    genPoint(x1,y1,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x4,y4,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x1,y1,dz,theColor,shininess,normal,mesh);
+    genPoint(x4,y4,dz,theColor,shininess,normal,mesh);
     
     
-    genPoint(x2,y2,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x2,y2,dz,theColor,shininess,normal,mesh);
     
     
     normal = normalize(cross(vec3(x4-x2,y4-y2,0),vec3(x3-x4,y3-y4,0)));
-    genPoint(x2,y2,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x4,y4,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x3,y3,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x2,y2,dz,theColor,shininess,normal,mesh);
+    genPoint(x4,y4,dz,theColor,shininess,normal,mesh);
+    genPoint(x3,y3,dz,theColor,shininess,normal,mesh);
     
     
 #if COLOR_FIXED
@@ -703,119 +699,88 @@ static void genPolyhedron6(double x1, double y1, double x2, double y2,
 #endif
     // generate vertices for rear face   v1 = x2-x2;
     normal = -normalize(cross(vec3(x4-x1,y4-y1,0),vec3(x2-x4,y2-y4,0)));
-    genPoint(x1,y1,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x2,y2,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x1,y1,-dz,theColor,shininess,normal,mesh);
+    genPoint(x2,y2,-dz,theColor,shininess,normal,mesh);
     
     
-    genPoint(x4,y4,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x4,y4,-dz,theColor,shininess,normal,mesh);
     
     
     normal = normalize(cross(vec3(x2-x4,y2-y4,0),vec3(x3-x2,y3-y2,0)));
-    genPoint(x4,y4,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x2,y2,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x3,y3,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x4,y4,-dz,theColor,shininess,normal,mesh);
+    genPoint(x2,y2,-dz,theColor,shininess,normal,mesh);
+    genPoint(x3,y3,-dz,theColor,shininess,normal,mesh);
     
 #if COLOR_FIXED
     theColor = vec4(1.0,1.0,0.0,1.0); // YELLOW
 #endif
     // generate vertices for top face
     normal = -normalize(cross(vec3(0,0,-dz-dz),vec3(x2-x1,y2-y1,dz-(-dz))));
-    genPoint(x1,y1,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x2,y2,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x1,y1,dz,theColor,shininess,normal,mesh);
+    genPoint(x2,y2,dz,theColor,shininess,normal,mesh);
     normal = normalize(cross(vec3(x2-x1,y2-y1,dz-(-dz)),vec3(0,0,-dz-dz)));
     
     
-    genPoint(x1,y1,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x1,y1,-dz,theColor,shininess,normal,mesh);
     
-    genPoint(x1,y1,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x2,y2,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x2,y2,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x1,y1,-dz,theColor,shininess,normal,mesh);
+    genPoint(x2,y2,dz,theColor,shininess,normal,mesh);
+    genPoint(x2,y2,-dz,theColor,shininess,normal,mesh);
     
 #if COLOR_FIXED
     theColor = vec4(0.0,0.0,1.0,1.0); // BLUE
 #endif
     // generate vertices for bottom face
     normal = normalize(cross(vec3(x4-x3,y4-y3,0),vec3(x3-x4,y3-y4,-dz-dz)));
-    genPoint(x3,y3,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x3,y3,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x3,y3,dz,theColor,shininess,normal,mesh);
+    genPoint(x3,y3,-dz,theColor,shininess,normal,mesh);
     
     
-    genPoint(x4,y4,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x4,y4,dz,theColor,shininess,normal,mesh);
     
     normal = -normalize(cross(vec3(x4-x3,y4-y3,0),vec3(0,0,dz-(-dz))));
-    genPoint(x3,y3,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x4,y4,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x4,y4,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x3,y3,-dz,theColor,shininess,normal,mesh);
+    genPoint(x4,y4,-dz,theColor,shininess,normal,mesh);
+    genPoint(x4,y4,dz,theColor,shininess,normal,mesh);
     
 #if COLOR_FIXED
     theColor = vec4(0.0,1.0,0.0,1.0); // GREEN
 #endif
     // generate vertices for left face
     normal = normalize(cross(vec3(0,0,-dz-dz),vec3(x4-x1,y4-y1,dz-(-dz))));
-    genPoint(x1,y1,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x1,y1,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x1,y1,dz,theColor,shininess,normal,mesh);
+    genPoint(x1,y1,-dz,theColor,shininess,normal,mesh);
     
     
-    genPoint(x4,y4,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x4,y4,dz,theColor,shininess,normal,mesh);
 
     normal = normalize(cross(vec3(x1-x4,y1-y4,-dz-dz),vec3(x4-x1,y4-y1,0)));
-    genPoint(x4,y4,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x1,y1,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x4,y4,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x4,y4,dz,theColor,shininess,normal,mesh);
+    genPoint(x1,y1,-dz,theColor,shininess,normal,mesh);
+    genPoint(x4,y4,-dz,theColor,shininess,normal,mesh);
     
 #if COLOR_FIXED
     theColor = vec4(0.0,0.25,0.0,1.0); // dark green
 #endif
     // generate vertices for right face
     normal = -normalize(cross(vec3(x2-x3,y2-y3,0),vec3(x3-x2,y3-y2,-dz-dz)));
-    genPoint(x3,y3,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x3,y3,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x3,y3,dz,theColor,shininess,normal,mesh);
+    genPoint(x3,y3,-dz,theColor,shininess,normal,mesh);
     
     
-    genPoint(x2,y2,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x2,y2,dz,theColor,shininess,normal,mesh);
     
 
     normal = -normalize(cross(vec3(0,0,-dz-dz),vec3(x3-x2,y3-y2,0)));
-    genPoint(x2,y2,dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x3,y3,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
-    genPoint(x2,y2,-dz,theColor,shininess,normal,idxVar,pointsArray,
-             normalsArray,color1Array,color2Array,color3Array,shininessArray);
+    genPoint(x2,y2,dz,theColor,shininess,normal,mesh);
+    genPoint(x3,y3,-dz,theColor,shininess,normal,mesh);
+    genPoint(x2,y2,-dz,theColor,shininess,normal,mesh);
 }
 
 static void genPrism(double at1X, double at1Y, double at2X, double at2Y,
                      double dyWidth, double dxWidth, double dz, vec4 theColor,
                      GLfloat shininess,
-                     int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                     vec4 *color2Array, vec4 *color3Array, GLfloat *shininessArray) {
+                     Mesh& mesh) {
     
     double x1 = at1X-dyWidth;
     double x2 = at1X+dyWidth;
@@ -827,19 +792,15 @@ static void genPrism(double at1X, double at1Y, double at2X, double at2Y,
     double y4 = at2Y+dxWidth;
 
     genPolyhedron6(x1, y1, x2, y2, x3, y3, x4, y4, dz,theColor,shininess,
-                   idxVar,pointsArray,normalsArray,color1Array,color2Array,color3Array,
-                   shininessArray);
+                   mesh);
 }
 
 static void genArc(double centerX, double centerY, double radius,
                    double startAngle, double endAngle,
                    double width, double divCircle, double dz, vec4 theColor, GLfloat shininess,
-                   int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                   vec4 *color2Array, vec4 *color3Array, GLfloat *shininessArray) {
-    if (startAngle >= endAngle) return;
-    if (divCircle <= 0) divCircle = 1;
-    
-    int count = (int)(divCircle*(endAngle-startAngle));
+                   Mesh& mesh) {
+    int count = arcSegments(startAngle, endAngle, divCircle);
+    if (count <= 0) return;
     startAngle *= 2*M_PI;
     endAngle *= 2*M_PI;
     double totalAngle = endAngle-startAngle;
@@ -863,15 +824,13 @@ static void genArc(double centerX, double centerY, double radius,
                        centerY + sin1*(radius-halfWidth),
                        
 
-                       dz,theColor,shininess,idxVar,pointsArray,normalsArray,
-                       color1Array,color2Array,color3Array,shininessArray);
+                       dz,theColor,shininess,mesh);
     }
     
 }
 
 static void genLetter(const CoordList& list, double width, double dz, vec4 theColor, GLfloat shininess,
-                      int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                      vec4 *color2Array, vec4 *color3Array, GLfloat *shininessArray) {
+                      int arcDivisions, Mesh& mesh) {
     for (const CoordList* cl = &list; cl != NULL; cl = cl->next) {
         double code = cl->thisOne.coords[0];
         if ((code == LINE || code == LINE_EXTEND)) {
@@ -900,16 +859,14 @@ static void genLetter(const CoordList& list, double width, double dz, vec4 theCo
                     at2Y -= dyWidth;
                 }
                 genPrism(at1X, at1Y, at2X, at2Y, dyWidth, dxWidth, dz, theColor, shininess,
-                         idxVar, pointsArray, normalsArray, color1Array, color2Array, color3Array,
-                         shininessArray);
+                         mesh);
             }
         }
         else if (code == ARC) {
             genArc(cl->thisOne.coords[1], cl->thisOne.coords[2],
                    cl->thisOne.coords[3], cl->thisOne.coords[4],
-                   cl->thisOne.coords[5], width, 32, dz, theColor, shininess,
-                   idxVar, pointsArray, normalsArray, color1Array,
-                   color2Array, color3Array, shininessArray);
+                   cl->thisOne.coords[5], width, arcDivisions, dz, theColor, shininess,
+                   mesh);
         }
         else if (code != INVISIBLE) {
             cerr << "Invalid spec for letter sub-object" << endl;
@@ -918,18 +875,68 @@ static void genLetter(const CoordList& list, double width, double dz, vec4 theCo
     
 }
 
-ObjRef genCharacter(char theLetter, vec4 theColor, double width, double z, GLfloat theShininess,
-                    int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                    vec4 *color2Array, vec4 *color3Array, GLfloat *shinyArray)
+// the vertex count of a letter, following the same steps as genLetter
+static int letterVertexCount(const CoordList& list, int arcDivisions) {
+    int count = 0;
+    for (const CoordList* cl = &list; cl != NULL; cl = cl->next) {
+        double code = cl->thisOne.coords[0];
+        if ((code == LINE || code == LINE_EXTEND)) {
+            double dx = cl->thisOne.coords[1]-cl->thisOne.coords[3];
+            double dy = cl->thisOne.coords[2]-cl->thisOne.coords[4];
+            if (dx*dx + dy*dy != 0) {
+                count += POLYHEDRON_VERTICES;
+            }
+        }
+        else if (code == ARC) {
+            count += POLYHEDRON_VERTICES*
+                arcSegments(cl->thisOne.coords[4], cl->thisOne.coords[5], arcDivisions);
+        }
+    }
+    return count;
+}
+
+int characterVertexCount(char theLetter, int arcDivisions) {
+    if (theLetter < ' ' || theLetter > '~') {
+        theLetter = ' ';
+    }
+    return letterVertexCount(characterCoords[theLetter-' '], arcDivisions);
+}
+
+ObjRef genCharacter(Mesh& mesh, char theLetter, vec4 theColor, double width, double z,
+                    GLfloat theShininess, int arcDivisions)
 {
-    int first = idxVar[0];
+    int first = mesh.size();
     
     if (theLetter < ' ' || theLetter > '~') {
         theLetter = ' ';
     }
     
     genLetter(characterCoords[theLetter-' '], width, z/2, theColor, theShininess,
-              idxVar, pointsArray, normalsArray, color1Array, color2Array, color3Array, shinyArray);
+              arcDivisions, mesh);
     
-    return ObjRef(first,idxVar[0]);
+    return mesh.objectFrom(first);
+}
+
+LodSet genCharacterLods(Mesh& mesh, char theLetter, vec4 theColor, double width, double z,
+                        GLfloat theShininess, int levels, GLfloat fullDetailSize)
+{
+    LodSet lods;
+    for (int i = 0; i < levels && i < LodSet::MAX_LEVELS; i++) {
+        int arcDivisions = ARC_DIVISIONS >> i;
+        if (arcDivisions < 1) break;
+        lods.add(genCharacter(mesh, theLetter, theColor, width, z, theShininess, arcDivisions),
+                 fullDetailSize / (1 << i));
+    }
+    return lods;
+}
+
+int characterLodsVertexCount(char theLetter, int levels)
+{
+    int count = 0;
+    for (int i = 0; i < levels && i < LodSet::MAX_LEVELS; i++) {
+        int arcDivisions = ARC_DIVISIONS >> i;
+        if (arcDivisions < 1) break;
+        count += characterVertexCount(theLetter, arcDivisions);
+    }
+    return count;
 }
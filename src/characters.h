@@ -7,18 +7,31 @@
 
 #ifndef __characters__
 #define __characters__
-#include "cs432.h"
 #include "vec.h"
+#include "mesh.h"
+#include "lod.h"
 
-ObjRef genCharacter(char theLetter, vec4 theColor, double width, double z, GLfloat theShininess,
-                    int *idxVar, vec4 *pointsArray, vec3 *normalsArray, vec4 *color1Array,
-                    vec4 *color2Array, vec4 *color3Array, GLfloat *shinyArray);
+// how many pieces a full circle is divided into, for the arcs in
+// characters, at full detail
+#define ARC_DIVISIONS 32
 
-inline ObjRef genCharacter(char theLetter, vec4 theColor, double width, double z,
-                           int *idxVar, vec4 *pointsArray, vec4 *colorArray) {
-    return genCharacter(theLetter, theColor, width, z, 0,
-                        idxVar, pointsArray, NULL, colorArray,
-                        NULL, NULL, NULL);
-}
+// generate a character as a solid stroke font: strokes of the given width,
+// the given depth in the z-direction, appending its vertices to the mesh;
+// arcs are made of straight pieces, arcDivisions of them to a full circle
+ObjRef genCharacter(Mesh& mesh, char theLetter, vec4 theColor, double width, double z,
+                    GLfloat theShininess = 0, int arcDivisions = ARC_DIVISIONS);
+
+// the number of vertices genCharacter generates for a character; this
+// depends only on the character's strokes, not on their width or depth
+int characterVertexCount(char theLetter, int arcDivisions = ARC_DIVISIONS);
+
+// generate a character at several levels of detail, each with half the arc
+// divisions of the one before; level i is for when the character is at
+// least fullDetailSize / 2^i pixels across (the last, for anything smaller)
+LodSet genCharacterLods(Mesh& mesh, char theLetter, vec4 theColor, double width, double z,
+                        GLfloat theShininess, int levels, GLfloat fullDetailSize);
+
+// the number of vertices genCharacterLods generates
+int characterLodsVertexCount(char theLetter, int levels);
 
 #endif /* defined(__characters__) */
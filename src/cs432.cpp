@@ -3,6 +3,9 @@
  */
 
 #include "cs432.h"
+#include <stdio.h>
+#include <string.h>
+#include "glState.h"
 
 // Create a NULL-terminated string by reading the provided file
 static char*
@@ -90,8 +93,10 @@ InitShader(const char* vShaderFile, const char* fShaderFile)
 		exit( EXIT_FAILURE );
 	}
 	
-	/* use program object */
-	glUseProgram(program);
+	/* use program object (nothing remembered about an earlier program
+	   with its name still holds) */
+	stateForget();
+	stateUseProgram(program);
 	
 	return program;
 }
@@ -151,8 +156,47 @@ InitShader2(const GLchar* vShaderCode, const GLchar* fShaderCode)
 		exit( EXIT_FAILURE );
 	}
 	
-	/* use program object */
-	glUseProgram(program);
+	/* use program object (nothing remembered about an earlier program
+	   with its name still holds) */
+	stateForget();
+	stateUseProgram(program);
 	
 	return program;
 }
+
+//----------------------------------------------------------------------------
+
+// Whether the current context is at least the given OpenGL version
+bool
+glVersionAtLeast(int major, int minor)
+{
+	int haveMajor = 0, haveMinor = 0;
+	const char* version = (const char*)glGetString(GL_VERSION);
+	if (version == NULL || sscanf(version, "%d.%d", &haveMajor, &haveMinor) != 2) {
+		return false;
+	}
+	return haveMajor > major || (haveMajor == major && haveMinor >= minor);
+}
+
+// Whether the current context offers the named extension
+bool
+glHasExtension(const char* name)
+{
+	if (!glVersionAtLeast(3, 0)) { // no glGetStringi; search the old list
+		const char* list = (const char*)glGetString(GL_EXTENSIONS);
+		size_t len = strlen(name);
+		for (const char* p = list; p != NULL && (p = strstr(p, name)) != NULL; p += len) {
+			if ((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0')) {
+				return true;
+			}
+		}
+		return false;
+	}
+	GLint numExtensions = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+	for (GLint i = 0; i < numExtensions; i++) {
+		const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (ext != NULL && strcmp(ext, name) == 0) { return true; }
+	}
+	return false;
+}
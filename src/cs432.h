@@ -45,10 +45,22 @@ inline int fopen_s(FILE** fpp, const char* name, const char* mode) {
 	return *fpp != NULL;
 }
 inline void glewInit(void){ }
-#else // non-Mac OS X operating systems
+#elif defined(_WIN32) // Windows: extensions are loaded through GLEW
 #  include <GL/glew.h>
 #  include <GL/freeglut.h>
 #  include <GL/freeglut_ext.h>
+#else // Linux and other Unix systems: libGL exports the entry points
+#  define GL_GLEXT_PROTOTYPES 1
+#  include <GL/gl.h>
+#  include <GL/glext.h>
+#  include <GL/freeglut.h>
+#  include <GL/freeglut_ext.h>
+#  include <stdio.h>
+inline int fopen_s(FILE** fpp, const char* name, const char* mode) {
+	*fpp = fopen(name, mode);
+	return *fpp == NULL;
+}
+inline void glewInit(void){ }
 #endif  // __APPLE__
 
 // Define a helpful macro for handling offsets into buffer objects
@@ -67,25 +79,19 @@ inline void glewInit(void){ }
 	GLuint InitShader2( const char* vShaderCode,
 					  const char* fShaderCode );
 	
-	//  Defined constant for when numbers are too small to be used in the
-	//    denominator of a division operation.  This is only used if the
-	//    DEBUG macro is defined.
-	const GLfloat  DivideByZeroTolerance = GLfloat(1.0e-07);
+	//  Whether the current context is at least the given OpenGL version
+	bool glVersionAtLeast( int major, int minor );
+	
+	//  Whether the current context offers the named extension
+	bool glHasExtension( const char* name );
 	
 	//  Degrees-to-radians constant 
 	const GLfloat  DegreesToRadians = M_PI / 180.0;
 
 
 //----------------------------------------------------------------------------
-// class that defines a reference to an object on the GPU
+// class that defines a reference to an object on the GPU (see mesh.h)
 //----------------------------------------------------------------------------
-class ObjRef {
-	int startIdx;
-	int count;
-public:
-	inline ObjRef(int start=0, int end=0):startIdx(start),count(end-start) { } // constructor
-	inline int getStartIdx() { return startIdx; } // getter-function for start index
-	inline int getCount() { return count; } // getter-function for count
-};
+#include "mesh.h"
 	
 #endif // __CS432_H__
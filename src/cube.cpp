@@ -0,0 +1,71 @@
+/*
+ * Cube geometry: a unit cube centered at the origin, faces aligned with
+ * the axes, each face drawn as two triangles.
+ */
+
+#include "vec.h"
+#include "cube.h"
+
+typedef vec4 color4;
+typedef vec4 point4;
+
+// Vertices of a unit cube centered at origin, faces aligned with axes
+static const point4 vertices[8] = {
+    point4(-0.5, -0.5,  0.5, 1.0),
+    point4(-0.5,  0.5,  0.5, 1.0),
+    point4(0.5,  0.5,  0.5, 1.0),
+    point4(0.5, -0.5,  0.5, 1.0),
+    point4(-0.5, -0.5, -0.5, 1.0),
+    point4(-0.5,  0.5, -0.5, 1.0),
+    point4(0.5,  0.5, -0.5, 1.0),
+    point4(0.5, -0.5, -0.5, 1.0),
+};
+
+// produces a quadralateral given its four corner-points, a, b, c and d.
+// - col is the color
+// - shininess is the shininess coefficient
+//
+// The ambient, specular and diffuse colors are all set to be the same color.
+static void
+quad(Mesh& mesh, point4 a, point4 b, point4 c, point4 d, color4 col, GLfloat shininess)
+{
+    // compute the normal vector for this face by taking a cross product
+    vec4 u = b - a;
+    vec4 v = c - b;
+    vec3 normal = normalize(cross(u, v));
+
+    // create the two triangles
+    mesh.add(a, normal, col, shininess);
+    mesh.add(b, normal, col, shininess);
+    mesh.add(c, normal, col, shininess);
+    mesh.add(a, normal, col, shininess);
+    mesh.add(c, normal, col, shininess);
+    mesh.add(d, normal, col, shininess);
+}
+
+// quad generates a square (of our cube) using two triangles
+//
+// parameters:
+// - a, b, c and d: the vertex-numbers for this square
+static void
+quad(Mesh& mesh, int a, int b, int c, int d, color4 col, GLfloat shininess)
+{
+    quad(mesh, vertices[a], vertices[b], vertices[c], vertices[d], col, shininess);
+}
+
+// 6 faces of 2 triangles each
+int cubeVertexCount(void) {
+    return 6 * 2 * 3;
+}
+
+ObjRef genCube(Mesh& mesh, color4 color, GLfloat shininess)
+{
+    int startIdx = mesh.size();
+    quad(mesh, 1, 0, 3, 2, color, shininess);
+    quad(mesh, 5, 4, 0, 1, color, shininess);
+    quad(mesh, 6, 5, 1, 2, color, shininess);
+    quad(mesh, 3, 0, 4, 7, color, shininess);
+    quad(mesh, 2, 3, 7, 6, color, shininess);
+    quad(mesh, 4, 5, 6, 7, color, shininess);
+    return mesh.objectFrom(startIdx);
+}
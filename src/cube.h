@@ -0,0 +1,19 @@
+/*
+ * Cube geometry: a unit cube centered at the origin, faces aligned with
+ * the axes, each face drawn as two triangles.
+ */
+
+#ifndef __CUBE_H__
+#define __CUBE_H__
+
+#include "vec.h"
+#include "mesh.h"
+
+// generate a cube of the given color and shininess, appending its vertices
+// to the mesh
+extern ObjRef genCube(Mesh& mesh, vec4 color, GLfloat shininess);
+
+// the number of vertices genCube generates
+extern int cubeVertexCount(void);
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * View-frustum culling: which objects' bounding spheres can be seen.
+ */
+
+#include "cull.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define CULL_SSE 1
+#endif
+
+// plane from row 3 plus or minus another row, scaled to a unit normal so
+// that distances to it are true distances
+static vec4 plane(const mat4& m, int row, GLfloat sign) {
+    vec4 p = m[3] + sign * m[row];
+    GLfloat len = sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+    return len > 0 ? p / len : p;
+}
+
+// for clip coordinates (x, y, z, w) a point is in view when each of x, y
+// and z lies between -w and w, i.e., when row3 +/- row_i is non-negative
+ViewFrustum frustumFromMatrix(const mat4& m) {
+    ViewFrustum f;
+    f.planes[0] = plane(m, 0, 1);   // left
+    f.planes[1] = plane(m, 0, -1);  // right
+    f.planes[2] = plane(m, 1, 1);   // bottom
+    f.planes[3] = plane(m, 1, -1);  // top
+    f.planes[4] = plane(m, 2, 1);   // near
+    f.planes[5] = plane(m, 2, -1);  // far
+    return f;
+}
+
+GLfloat largestScale(const mat4& m) {
+    GLfloat scale2 = 0;
+    for (int col = 0; col < 3; col++) {
+        GLfloat len2 = m[0][col] * m[0][col] + m[1][col] * m[1][col] + m[2][col] * m[2][col];
+        if (len2 > scale2) scale2 = len2;
+    }
+    return sqrt(scale2);
+}
+
+void SphereBatch::clear(void) {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+void SphereBatch::add(const vec3& center, GLfloat r) {
+    x.push_back(center.x);
+    y.push_back(center.y);
+    z.push_back(center.z);
+    radius.push_back(r);
+}
+
+void SphereBatch::resize(int n) {
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    radius.resize(n);
+}
+
+void SphereBatch::set(int i, const vec3& center, GLfloat r) {
+    x[i] = center.x;
+    y[i] = center.y;
+    z[i] = center.z;
+    radius[i] = r;
+}
+
+// one sphere: out of view if it lies entirely behind any plane
+static bool sphereVisible(const ViewFrustum& f, GLfloat x, GLfloat y, GLfloat z, GLfloat r) {
+    for (int p = 0; p < 6; p++) {
+        const vec4& pl = f.planes[p];
+        if (pl.x * x + pl.y * y + pl.z * z + pl.w < -r) return false;
+    }
+    return true;
+}
+
+int cullSpheres(const ViewFrustum& frustum, const SphereBatch& spheres,
+                std::vector<unsigned char>& visible) {
+    int n = spheres.size();
+    visible.resize(n);
+    return n > 0 ? cullSpheres(frustum, spheres, 0, n, &visible[0]) : 0;
+}
+
+int cullSpheres(const ViewFrustum& frustum, const SphereBatch& spheres,
+                int begin, int end, unsigned char* visible) {
+    int n = end;
+    int numVisible = 0;
+    int i = begin;
+
+#ifdef CULL_SSE
+    // four spheres at a time, against each plane in turn
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; p++) {
+        px[p] = _mm_set1_ps(frustum.planes[p].x);
+        py[p] = _mm_set1_ps(frustum.planes[p].y);
+        pz[p] = _mm_set1_ps(frustum.planes[p].z);
+        pw[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(&spheres.x[i]);
+        __m128 y = _mm_loadu_ps(&spheres.y[i]);
+        __m128 z = _mm_loadu_ps(&spheres.z[i]);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], x), _mm_mul_ps(py[p], y)),
+                                  _mm_add_ps(_mm_mul_ps(pz[p], z), pw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; k++) {
+            visible[i + k] = (mask >> k) & 1;
+            numVisible += (mask >> k) & 1;
+        }
+    }
+#endif
+
+    // the rest (or, without SSE, all of them) one at a time
+    for (; i < n; i++) {
+        visible[i] = sphereVisible(frustum, spheres.x[i], spheres.y[i],
+                                   spheres.z[i], spheres.radius[i]);
+        numVisible += visible[i];
+    }
+    return numVisible;
+}
@@ -0,0 +1,59 @@
+/*
+ * View-frustum culling: which objects' bounding spheres can be seen.
+ *
+ * The six frustum planes come from a projection matrix (or a projection
+ * times model-view, for a frustum in model coordinates).  Spheres are
+ * tested in batches, kept as separate arrays of x, y, z and radius so that
+ * four of them at a time go through SSE2; without it the same test runs
+ * one sphere at a time.
+ */
+
+#ifndef __CULL_H__
+#define __CULL_H__
+
+#include "vec.h"
+#include "mat.h"
+#include <vector>
+
+// the planes bounding what a projection can see: left, right, bottom, top,
+// near, far.  A point p is inside plane i when dot(plane[i], p) >= 0.
+struct ViewFrustum {
+    vec4 planes[6];
+};
+
+// extract the (normalized) frustum planes from a matrix
+ViewFrustum frustumFromMatrix(const mat4& m);
+
+// a batch of spheres, in the frustum's coordinates
+struct SphereBatch {
+    std::vector<GLfloat> x, y, z, radius;
+
+    void clear(void);
+    void add(const vec3& center, GLfloat r);
+    void resize(int n);
+    void set(int i, const vec3& center, GLfloat r);
+    int size(void) const { return (int)x.size(); }
+};
+
+// set visible[i] to whether sphere i is at least partly inside the
+// frustum; returns how many are
+int cullSpheres(const ViewFrustum& frustum, const SphereBatch& spheres,
+                std::vector<unsigned char>& visible);
+
+// the same, for spheres begin to end-1 only (visible[] must have room);
+// batches can be split this way between threads
+int cullSpheres(const ViewFrustum& frustum, const SphereBatch& spheres,
+                int begin, int end, unsigned char* visible);
+
+// the largest factor by which a matrix scales lengths (that of the longest
+// column of its upper-left 3x3), e.g., to carry a bounding sphere's radius
+// through a model-view matrix
+GLfloat largestScale(const mat4& m);
+
+// what culling did in one frame
+struct CullStats {
+    int tested;  // objects tested
+    int culled;  // objects found out of view, and not drawn
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Dice faces: which face of a die is on top, and the resting orientation
+ * with that face exactly up.
+ */
+
+#include "diceFace.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define FACE_SSE 1
+#endif
+
+// the pips on each face, by face number (see diceFace.h)
+static const int VALUES[6] = { 2, 5, 3, 4, 1, 6 };
+
+// each face's outward normal, in the die's coordinates
+static const vec3 NORMALS[6] = {
+    vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0),
+    vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1)
+};
+
+int faceValue(int face) {
+    return face >= 0 && face < 6 ? VALUES[face] : 0;
+}
+
+vec3 faceNormal(int face) {
+    return face >= 0 && face < 6 ? NORMALS[face] : vec3(0, 0, 0);
+}
+
+// The rotation takes the normal of face 2k to column k of its matrix, and
+// that of face 2k+1 to minus the column; so of the six dot products with
+// 'up', three are the others negated.  The top face is the axis whose dot
+// product is largest in magnitude, with the face on the side of its sign.
+
+// the top face, given the dot products of 'up' with the three columns
+static int faceFromDots(GLfloat d0, GLfloat d1, GLfloat d2) {
+    GLfloat a0 = fabs(d0), a1 = fabs(d1), a2 = fabs(d2);
+    if (a0 >= a1 && a0 >= a2) return d0 < 0 ? 1 : 0;
+    if (a1 >= a2) return d1 < 0 ? 3 : 2;
+    return d2 < 0 ? 5 : 4;
+}
+
+// the dot product of 'up' with column k of a rotation
+static inline GLfloat columnDot(const mat4& r, int k, const vec3& up) {
+    return up.x * r[0][k] + up.y * r[1][k] + up.z * r[2][k];
+}
+
+void topFaces(const mat4* rotations, int n, const vec3& up, int* faces) {
+    int i = 0;
+
+#ifdef FACE_SSE
+    // four dice at a time: one lane per die
+    const __m128 ux = _mm_set1_ps(up.x), uy = _mm_set1_ps(up.y), uz = _mm_set1_ps(up.z);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    for (; i + 4 <= n; i += 4) {
+        const mat4* r = rotations + i;
+        __m128 d[3];
+        for (int k = 0; k < 3; k++) {
+            __m128 x = _mm_set_ps(r[3][0][k], r[2][0][k], r[1][0][k], r[0][0][k]);
+            __m128 y = _mm_set_ps(r[3][1][k], r[2][1][k], r[1][1][k], r[0][1][k]);
+            __m128 z = _mm_set_ps(r[3][2][k], r[2][2][k], r[1][2][k], r[0][2][k]);
+            d[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ux, x), _mm_mul_ps(uy, y)),
+                              _mm_mul_ps(uz, z));
+        }
+        __m128 a0 = _mm_andnot_ps(signBit, d[0]);
+        __m128 a1 = _mm_andnot_ps(signBit, d[1]);
+        __m128 a2 = _mm_andnot_ps(signBit, d[2]);
+
+        // which axis wins (as in faceFromDots), and its dot product
+        __m128 is0 = _mm_and_ps(_mm_cmpge_ps(a0, a1), _mm_cmpge_ps(a0, a2));
+        __m128 is1 = _mm_andnot_ps(is0, _mm_cmpge_ps(a1, a2));
+        __m128 is2 = _mm_andnot_ps(_mm_or_ps(is0, is1), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+        __m128 winner = _mm_or_ps(_mm_and_ps(is0, d[0]),
+                        _mm_or_ps(_mm_and_ps(is1, d[1]), _mm_and_ps(is2, d[2])));
+
+        // face = 2 * axis, plus one on the negative side
+        __m128i face = _mm_or_si128(_mm_and_si128(_mm_castps_si128(is1), two),
+                                    _mm_and_si128(_mm_castps_si128(is2), _mm_set1_epi32(4)));
+        __m128i negative = _mm_castps_si128(_mm_cmplt_ps(winner, _mm_setzero_ps()));
+        face = _mm_add_epi32(face, _mm_and_si128(negative, one));
+        _mm_storeu_si128((__m128i*)(faces + i), face);
+    }
+#endif
+
+    // the rest (or, without SSE2, all of them) one at a time
+    for (; i < n; i++) {
+        const mat4& r = rotations[i];
+        faces[i] = faceFromDots(columnDot(r, 0, up), columnDot(r, 1, up),
+                                columnDot(r, 2, up));
+    }
+}
+
+int topFace(const mat4& rotation, const vec3& up) {
+    int face;
+    topFaces(&rotation, 1, up, &face);
+    return face;
+}
+
+quat restOrientation(const quat& q, int face, const vec3& up) {
+    if (face < 0 || face >= 6) return q;
+    // turn the least that brings the face's normal onto 'up': the die
+    // keeps its heading, and only tips onto the face
+    vec3 normal = rotate(q, NORMALS[face]);
+    return normalize(rotationBetween(normal, up) * q);
+}
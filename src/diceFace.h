@@ -0,0 +1,33 @@
+/*
+ * Dice faces: which face of a die is on top, and the resting orientation
+ * with that face exactly up.
+ *
+ * Faces are numbered by their outward normals in the die's own
+ * coordinates: 0 is +x, 1 is -x, 2 is +y, 3 is -y, 4 is +z and 5 is -z.
+ * Opposite faces' values add up to seven, as on a real die.
+ */
+
+#ifndef __DICE_FACE_H__
+#define __DICE_FACE_H__
+
+#include "mat.h"
+#include "quat.h"
+
+// the pips on each face
+int faceValue(int face);
+
+// a face's outward normal, in the die's own coordinates
+vec3 faceNormal(int face);
+
+// the face of each of n dice (given their rotations) that points most
+// nearly along 'up'; cheap enough to run for every die on every step
+void topFaces(const mat4* rotations, int n, const vec3& up, int* faces);
+
+// the same, for one die
+int topFace(const mat4& rotation, const vec3& up);
+
+// the orientation nearest q in which 'face' points exactly along 'up'
+// (a unit vector), i.e., the die come to rest on the opposite face
+quat restOrientation(const quat& q, int face, const vec3& up);
+
+#endif
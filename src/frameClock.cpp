@@ -0,0 +1,159 @@
+/*
+ * Frame-clock code; a monotonic high-resolution clock, a fixed-timestep
+ * accumulator for the simulation, and a histogram of frame times.
+ */
+
+#include "cs432.h"
+#include "frameClock.h"
+#include <chrono>
+#include <iomanip>
+
+#if defined(_WIN32)
+#  include <GL/wglew.h>
+#elif !defined(__APPLE__)
+#  include <GL/glx.h>
+#endif
+
+// the moment the clock was first consulted
+static const std::chrono::steady_clock::time_point startTime =
+    std::chrono::steady_clock::now();
+
+// seconds since the program started, on a clock that never goes backward
+double clockNow(void) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - startTime;
+    return elapsed.count();
+}
+
+// set the swap interval, using whichever extension the platform provides
+void setSwapInterval(int interval) {
+#if defined(_WIN32)
+    if (WGLEW_EXT_swap_control) {
+        wglSwapIntervalEXT(interval);
+    }
+#elif defined(__APPLE__)
+    GLint value = interval;
+    CGLSetParameter(CGLGetCurrentContext(), kCGLCPSwapInterval, &value);
+#else
+    typedef int (*swapIntervalFunction)(int);
+    swapIntervalFunction fcn = (swapIntervalFunction)
+        glXGetProcAddress((const GLubyte*)"glXSwapIntervalMESA");
+    if (fcn == NULL) {
+        fcn = (swapIntervalFunction)
+            glXGetProcAddress((const GLubyte*)"glXSwapIntervalSGI");
+    }
+    if (fcn != NULL) {
+        fcn(interval);
+    }
+#endif
+}
+
+const char* renderModeName(RenderMode mode) {
+    switch (mode) {
+    case RENDER_VSYNC: return "vsync";
+    case RENDER_UNCAPPED: return "uncapped";
+    default: return "unknown";
+    }
+}
+
+//----------------------------------------------------------------------------
+//  FrameClock
+//----------------------------------------------------------------------------
+
+// constructor: if we fall more than a quarter-second behind (e.g., the
+// window was being dragged), drop the excess rather than running a burst
+// of steps to catch up
+FrameClock::FrameClock(double stepSeconds)
+    :_step(stepSeconds), _maxFrame(0.25), _lastTime(0), _accumulator(0),
+     _ticks(0), _started(false)
+{ }
+
+int FrameClock::advance(double now) {
+    if (!_started) {
+        _started = true;
+        _lastTime = now;
+        return 0;
+    }
+    double frameTime = now - _lastTime;
+    _lastTime = now;
+    if (frameTime > _maxFrame) frameTime = _maxFrame;
+    if (frameTime < 0) frameTime = 0;
+
+    _accumulator += frameTime;
+    int steps = 0;
+    while (_accumulator >= _step) {
+        _accumulator -= _step;
+        steps++;
+    }
+    _ticks += steps;
+    return steps;
+}
+
+//----------------------------------------------------------------------------
+//  FrameHistogram
+//----------------------------------------------------------------------------
+
+FrameHistogram::FrameHistogram() {
+    reset();
+}
+
+void FrameHistogram::reset() {
+    for (int i = 0; i < NumBuckets; i++) _buckets[i] = 0;
+    _count = 0;
+    _total = 0;
+    _min = 0;
+    _max = 0;
+}
+
+void FrameHistogram::record(double seconds) {
+    int bucket = (int)(seconds * 1000.0);
+    if (bucket < 0) bucket = 0;
+    if (bucket >= NumBuckets) bucket = NumBuckets - 1;
+    _buckets[bucket]++;
+    if (_count == 0 || seconds < _min) _min = seconds;
+    if (_count == 0 || seconds > _max) _max = seconds;
+    _count++;
+    _total += seconds;
+}
+
+// walk the buckets until we have passed the requested fraction of frames;
+// the answer is the upper edge of that bucket
+double FrameHistogram::percentile(double fraction) const {
+    if (_count == 0) return 0.0;
+    long target = (long)(fraction * _count);
+    long seen = 0;
+    for (int i = 0; i < NumBuckets; i++) {
+        seen += _buckets[i];
+        if (seen > target) {
+            return i < NumBuckets - 1 ? (i + 1) / 1000.0 : _max;
+        }
+    }
+    return _max;
+}
+
+void FrameHistogram::print(std::ostream& os) const {
+    os << "frames: " << _count << std::fixed << std::setprecision(2)
+       << "  mean: " << mean() * 1000 << " ms"
+       << "  min: " << _min * 1000 << " ms"
+       << "  max: " << _max * 1000 << " ms"
+       << "  p50: " << percentile(0.50) * 1000 << " ms"
+       << "  p99: " << percentile(0.99) * 1000 << " ms" << std::endl;
+
+    // scale the bars so that the fullest bucket is 50 characters wide
+    long most = 1;
+    for (int i = 0; i < NumBuckets; i++) {
+        if (_buckets[i] > most) most = _buckets[i];
+    }
+    for (int i = 0; i < NumBuckets; i++) {
+        if (_buckets[i] == 0) continue;
+        os << std::setw(3) << i << (i < NumBuckets - 1 ? "  ms " : "+ ms ")
+           << std::setw(7) << _buckets[i] << " "
+           << std::string((size_t)(50 * _buckets[i] / most), '#') << std::endl;
+    }
+}
+
+// print the histogram to an output stream (operator version)
+std::ostream& operator << ( std::ostream& os, const FrameHistogram& h ) {
+    h.print(os);
+    return os;
+}
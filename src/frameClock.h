@@ -0,0 +1,95 @@
+/*
+ * Frame-clock code; a monotonic high-resolution clock, a fixed-timestep
+ * accumulator for the simulation, and a histogram of frame times.
+ *
+ * The simulation always advances in steps of the same length, no matter
+ * how often the scene is redrawn; rendering interpolates between the last
+ * two simulation states using the alpha value from the clock.
+ */
+
+#ifndef __FRAMECLOCK_H__
+#define __FRAMECLOCK_H__
+
+#include <iostream>
+
+// the ways in which frames can be paced
+enum RenderMode {
+    RENDER_VSYNC,    // redraw continuously, swaps wait for the vertical blank
+    RENDER_UNCAPPED, // redraw continuously, as fast as possible
+    NUM_RENDER_MODES
+};
+
+// seconds elapsed on a monotonic clock since the program started
+double clockNow(void);
+
+// ask the driver to wait for 'interval' vertical blanks on each buffer swap
+// (0 disables vsync); silently does nothing if the platform cannot do it
+void setSwapInterval(int interval);
+
+// human-readable name of a render mode
+const char* renderModeName(RenderMode mode);
+
+//----------------------------------------------------------------------------
+// fixed-timestep simulation clock
+//----------------------------------------------------------------------------
+class FrameClock {
+    double _step;        // length of one simulation step, in seconds
+    double _maxFrame;    // longest frame we will try to catch up on
+    double _lastTime;    // time at which the previous frame began
+    double _accumulator; // time not yet consumed by simulation steps
+    long   _ticks;       // number of simulation steps taken so far
+    bool   _started;
+
+public:
+    // constructor: parameter gives simulation step in seconds
+    FrameClock(double stepSeconds);
+
+    // begin a new frame at time 'now'; returns the number of simulation
+    // steps that must be run to catch the simulation up with real time
+    int advance(double now);
+
+    // fraction of a step by which real time is ahead of the simulation;
+    // used to interpolate between the previous and current states
+    double alpha() const { return _accumulator / _step; }
+
+    // length of a step and number of steps taken
+    double step() const { return _step; }
+    long ticks() const { return _ticks; }
+};
+
+//----------------------------------------------------------------------------
+// histogram of frame times, in 1-millisecond buckets
+//----------------------------------------------------------------------------
+class FrameHistogram {
+public:
+    static const int NumBuckets = 64; // last bucket holds everything longer
+private:
+    long   _buckets[NumBuckets];
+    long   _count;
+    double _total;
+    double _min;
+    double _max;
+
+public:
+    FrameHistogram();
+
+    // record one frame time, in seconds
+    void record(double seconds);
+
+    // forget everything recorded so far
+    void reset();
+
+    // frame time (in seconds) below which the given fraction of frames fall
+    double percentile(double fraction) const;
+
+    long count() const { return _count; }
+    double mean() const { return _count > 0 ? _total / _count : 0.0; }
+
+    // print a summary plus a bar for each non-empty bucket
+    void print(std::ostream& os) const;
+};
+
+// operator version of print method
+std::ostream& operator << ( std::ostream& os, const FrameHistogram& h );
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Game-state code for Pig: the dice roll, turns and scoring, and the
+ * moving light.
+ */
+
+#include "game.h"
+#include "diceFace.h"
+#include "pigAI.h"
+#include <string.h>
+
+// how fast things move, per second of game time
+static const float LIGHT_SPEED = 100.0;   // degrees
+static const float SPIN_MIN = 360.0;      // degrees, about each axis
+static const int SPIN_RANGE = 720;        // degrees
+
+// the table: its height, where the dice sit on it, and which way is up
+static const float TABLE_Y = 0.5;
+static const float DICE_HALF_SIZE = 0.5;
+static const float DICE_X[NUM_DICE] = { 0, 1.5, -1.5, -3, 3 };
+static const vec3 UP(0, 1, 0);
+
+// how fast a rolled dice leaves the table (enough to rise about 8 units
+// under the world's gravity of 60 units/s^2)
+static const float LAUNCH_SPEED = 31.0;
+
+// a roll that has not come to rest by now is stopped where it is
+static const float MAX_ROLL_TIME = 6.0;
+
+// a dice at rest whose top face is within this of level (the cosine of
+// the angle) is set down exactly flat
+static const float FLAT_ENOUGH = 0.98f;
+
+// how long a landed dice rests before its value counts
+static const double SETTLE_TIME = 0.5;
+
+// how long the AI waits before each move, so that it can be followed
+static const double AI_MOVE_TIME = 0.6;
+
+// the face each dice has on top
+static void findTopFaces(GameState& g) {
+    mat4 rotations[NUM_DICE];
+    for (int i = 0; i < NUM_DICE; i++) {
+        rotations[i] = toMat4(g.world.body(i).orientation);
+    }
+    topFaces(rotations, NUM_DICE, UP, g.topFace);
+}
+
+void gameInit(GameState& g, uint64_t seed) {
+    g.world = PhysicsWorld(TABLE_Y);
+    for (int i = 0; i < NUM_DICE; i++) {
+        g.world.addBox(vec3(DICE_X[i], TABLE_Y + DICE_HALF_SIZE, 0),
+                       eulerXYZ(0.0, 0.2, 0.723), DICE_HALF_SIZE);
+    }
+    findTopFaces(g);
+    g.rolling = false;
+    g.settling = false;
+    g.rollTime = 0;
+    g.myTurn = true;
+    g.myScore = 0;
+    g.AIScore = 0;
+    g.turnTotal = 0;
+    g.diceValue = 0;
+    g.lightSpin = true;
+    g.lightAngle = 0;
+    g.scheduler.clear();
+    g.rng.seed(seed);
+}
+
+static void aiMove(void* data, int);
+
+// the banked score of the player whose turn it is
+static int& turnScore(GameState& g) {
+    return g.myTurn ? g.myScore : g.AIScore;
+}
+
+bool gameOver(const GameState& g) {
+    return g.myScore >= WINNING_SCORE || g.AIScore >= WINNING_SCORE;
+}
+
+// hand the turn to the other player
+static void passTurn(GameState& g) {
+    g.myTurn = !g.myTurn;
+    if (!g.myTurn) g.scheduler.after(AI_MOVE_TIME, aiMove, &g);
+}
+
+// bank the turn total and, unless that wins, hand the turn over
+static void endTurn(GameState& g) {
+    if (pigBank(turnScore(g), g.turnTotal) == PIG_TURN_OVER) passTurn(g);
+}
+
+// scheduled callback: the dice has come to rest, so score the roll (see
+// pigRules.h)
+static void finishRoll(void* data, int) {
+    GameState& g = *(GameState*)data;
+    g.settling = false;
+    g.diceValue = faceValue(g.topFace[0]);
+    PigOutcome outcome = pigApplyRoll(turnScore(g), g.turnTotal, g.diceValue);
+    if (outcome == PIG_TURN_OVER) {
+        passTurn(g);
+    }
+    else if (outcome == PIG_ROLL_AGAIN && !g.myTurn) {
+        g.scheduler.after(AI_MOVE_TIME, aiMove, &g);
+    }
+}
+
+// the dice have stopped: set the rolled one down flat on its top face (if
+// it is lying nearly flat on the table, not propped against another), and
+// wait a moment before scoring it
+static void landed(GameState& g) {
+    for (int i = 0; i < NUM_DICE; i++) g.world.body(i).asleep = true;
+    RigidBox& dice = g.world.body(0);
+    vec3 normal = rotate(dice.orientation, faceNormal(g.topFace[0]));
+    if (dot(normal, UP) >= FLAT_ENOUGH && dice.position.y < TABLE_Y + 2 * DICE_HALF_SIZE) {
+        dice.orientation = restOrientation(dice.orientation, g.topFace[0], UP);
+        dice.position.y = TABLE_Y + DICE_HALF_SIZE;
+    }
+    g.rolling = false;
+    g.settling = true;
+    g.scheduler.after(SETTLE_TIME, finishRoll, &g);
+}
+
+void gameUpdate(GameState& g, double dt) {
+    // move the dice
+    if (g.rolling) {
+        g.world.step((float)dt);
+        findTopFaces(g);
+        g.rollTime += (float)dt;
+        if (g.world.allAsleep() || g.rollTime >= MAX_ROLL_TIME) {
+            landed(g);
+        }
+    }
+
+    // change the light angle
+    if (g.lightSpin) {
+        g.lightAngle += LIGHT_SPEED * (float)dt;
+    }
+
+    // run any timed events that have come due
+    g.scheduler.advance(dt);
+}
+
+// a random spin rate about one axis, in radians per second
+static float randomSpin(Rng& rng) {
+    float degrees = SPIN_MIN + rng.uniformf() * SPIN_RANGE;
+    return degrees * (float)(M_PI / 180);
+}
+
+// throw the dice
+static void startRoll(GameState& g) {
+    g.rolling = true;
+    g.rollTime = 0;
+    g.world.wake(0);
+    RigidBox& dice = g.world.body(0);
+    dice.position = vec3(DICE_X[0], TABLE_Y + DICE_HALF_SIZE, 0); // picked up
+    dice.velocity = vec3(0, LAUNCH_SPEED, 0);
+    dice.angularVelocity = vec3(randomSpin(g.rng), randomSpin(g.rng), randomSpin(g.rng));
+}
+
+// scheduled callback: the AI rolls or holds, as the solved game says
+static void aiMove(void* data, int) {
+    GameState& g = *(GameState*)data;
+    if (g.myTurn || g.rolling || g.settling || gameOver(g)) return;
+    if (pigShouldRoll(g.AIScore, g.myScore, g.turnTotal)) {
+        startRoll(g);
+    }
+    else {
+        endTurn(g);
+    }
+}
+
+// can the player act?
+static bool playerCanMove(const GameState& g) {
+    return g.myTurn && !g.rolling && !g.settling && !gameOver(g);
+}
+
+bool gameRoll(GameState& g) {
+    if (!playerCanMove(g)) return false;
+    startRoll(g);
+    return true;
+}
+
+void gameHold(GameState& g) {
+    if (playerCanMove(g)) endTurn(g);
+}
+
+void gameScaleSpin(GameState& g, float factor) {
+    RigidBox& dice = g.world.body(0);
+    if (!dice.asleep) dice.angularVelocity *= factor;
+}
+
+// FNV-1a, over the bytes of a value
+static void hashBytes(uint32_t& h, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+}
+
+static void hashFloat(uint32_t& h, float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    hashBytes(h, &bits, sizeof(bits));
+}
+
+static void hashInt(uint32_t& h, int v) {
+    hashBytes(h, &v, sizeof(v));
+}
+
+uint32_t gameChecksum(const GameState& g) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < NUM_DICE; i++) {
+        const RigidBox& b = g.world.body(i);
+        for (int k = 0; k < 3; k++) {
+            hashFloat(h, b.position[k]);
+            hashFloat(h, b.velocity[k]);
+            hashFloat(h, b.angularVelocity[k]);
+        }
+        hashFloat(h, b.orientation.w);
+        hashFloat(h, b.orientation.x);
+        hashFloat(h, b.orientation.y);
+        hashFloat(h, b.orientation.z);
+        hashInt(h, g.topFace[i]);
+    }
+    hashInt(h, g.rolling);
+    hashInt(h, g.settling);
+    hashInt(h, g.myTurn);
+    hashInt(h, g.myScore);
+    hashInt(h, g.AIScore);
+    hashInt(h, g.turnTotal);
+    hashInt(h, g.diceValue);
+    hashFloat(h, g.lightAngle);
+    return h;
+}
+
+GameSnapshot gameSnapshot(const GameState& g) {
+    GameSnapshot s;
+    for (int i = 0; i < NUM_DICE; i++) {
+        s.dicePosition[i] = g.world.body(i).position;
+        s.diceOrientation[i] = g.world.body(i).orientation;
+    }
+    s.topValue = faceValue(g.topFace[0]);
+    s.rolling = g.rolling;
+    s.lightAngle = g.lightAngle;
+    s.myTurn = g.myTurn;
+    s.myScore = g.myScore;
+    s.AIScore = g.AIScore;
+    s.turnTotal = g.turnTotal;
+    return s;
+}
+
+// blend one value
+static float lerp(float prev, float cur, double alpha) {
+    return (float)(prev + (cur - prev) * alpha);
+}
+
+// continuous values are blended; discrete ones come from the newer snapshot
+GameSnapshot gameInterpolate(const GameSnapshot& prev, const GameSnapshot& cur,
+                             double alpha) {
+    GameSnapshot s = cur;
+    for (int i = 0; i < NUM_DICE; i++) {
+        const vec3& p = prev.dicePosition[i];
+        const vec3& c = cur.dicePosition[i];
+        s.dicePosition[i] = vec3(lerp(p.x, c.x, alpha), lerp(p.y, c.y, alpha),
+                                 lerp(p.z, c.z, alpha));
+        s.diceOrientation[i] = nlerp(prev.diceOrientation[i], cur.diceOrientation[i],
+                                     (float)alpha);
+    }
+    s.lightAngle = lerp(prev.lightAngle, cur.lightAngle, alpha);
+    return s;
+}
@@ -0,0 +1,107 @@
+/*
+ * Game-state code for Pig: the dice roll, turns and scoring (the AI's
+ * turns played by pigAI), and the moving light.
+ *
+ * Nothing here touches OpenGL.  The simulation advances only through
+ * gameUpdate(); the renderer is handed a GameSnapshot, a plain copy of the
+ * values it needs, so drawing (or re-drawing for picking) can never change
+ * the game.
+ */
+
+#ifndef __GAME_H__
+#define __GAME_H__
+
+#include "scheduler.h"
+#include "quat.h"
+#include "physics.h"
+#include "rng.h"
+#include "pigRules.h"
+
+// number of dice on the table
+#define NUM_DICE 5
+
+// the state of one game
+struct GameState {
+    // the dice, as rigid bodies on the table (body i is dice i; the first
+    // is the one that is rolled), and the face each has on top (see
+    // diceFace.h)
+    PhysicsWorld world;
+    int topFace[NUM_DICE];
+
+    // rolling: the dice are moving; settling: they have come to rest, and
+    // the result will count once a short pause has elapsed
+    bool rolling;
+    bool settling;
+    float rollTime;      // how long the current roll has gone on
+
+    // scoring: whose turn it is, what each player has banked, and what
+    // the player whose turn it is has rolled so far this turn
+    bool myTurn;
+    int myScore;
+    int AIScore;
+    int turnTotal;
+    int diceValue;       // most recent roll, 0 before the first
+
+    // the light circling the scene
+    bool lightSpin;
+    float lightAngle;
+
+    // pending timed events (e.g., the end of the settling pause)
+    Scheduler scheduler;
+
+    // the game's own random numbers: the same seed, the same game
+    Rng rng;
+
+    // the scheduled events point back at this state, so it cannot be
+    // copied (a copy's events would change the original); snapshots are
+    // the way to keep its values
+    GameState() = default;
+    GameState(const GameState&) = delete;
+    GameState& operator = (const GameState&) = delete;
+};
+
+// everything the renderer needs to draw one frame
+struct GameSnapshot {
+    vec3 dicePosition[NUM_DICE];
+    quat diceOrientation[NUM_DICE];
+    int topValue;        // the value the rolled dice shows right now
+    bool rolling;
+    float lightAngle;
+    bool myTurn;
+    int myScore;
+    int AIScore;
+    int turnTotal;
+};
+
+// put a game into its starting state, its random numbers from 'seed'
+void gameInit(GameState& g, uint64_t seed = 0);
+
+// advance the game by dt seconds
+void gameUpdate(GameState& g, double dt);
+
+// the player rolls; returns false (and does nothing) if it is not the
+// player's turn, a roll is already under way, or the game is over
+bool gameRoll(GameState& g);
+
+// the player banks the turn total and hands the turn to the AI; does
+// nothing unless the player could roll
+void gameHold(GameState& g);
+
+// has someone won?
+bool gameOver(const GameState& g);
+
+// spin the rolled dice faster (factor > 1) or slower
+void gameScaleSpin(GameState& g, float factor);
+
+// a hash of the simulated state (the dice's bodies, bit for bit, and the
+// scores and turn), for checking that a replay follows its recording
+uint32_t gameChecksum(const GameState& g);
+
+// take a snapshot of the current state
+GameSnapshot gameSnapshot(const GameState& g);
+
+// blend two snapshots: alpha 0 gives 'prev', alpha 1 gives 'cur'
+GameSnapshot gameInterpolate(const GameSnapshot& prev, const GameSnapshot& cur,
+                             double alpha);
+
+#endif
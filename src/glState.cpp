@@ -0,0 +1,299 @@
+/*
+ * OpenGL state tracking: a thin layer over the OpenGL calls that change
+ * state, which remembers what has been set, so that setting something to
+ * the value it already has costs no driver call.
+ */
+
+#include "glState.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
+// one remembered uniform value: its size in floats (0 if unknown) and the
+// value itself (an int is kept by its bits)
+struct UniformSlot {
+    int size;
+    GLfloat value[16];
+};
+
+// each program's remembered uniforms, by location
+static std::map<GLuint, std::vector<UniformSlot> > uniforms;
+static std::vector<UniformSlot>* current = NULL;
+static GLuint currentProgram = 0;
+static bool programKnown = false;
+
+// the bound vertex array object
+static GLuint currentVao = 0;
+static bool vaoKnown = false;
+
+// buffers bound to targets, and ranges of them to indexed targets
+struct BufferRange {
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size;
+};
+static std::map<GLenum, GLuint> buffers;
+static std::map<std::pair<GLenum, GLuint>, BufferRange> ranges;
+
+// each vertex array object's enabled attribute arrays: which are known,
+// and of those, which are enabled (one bit per attribute index)
+struct AttribArrays {
+    unsigned known;
+    unsigned enabled;
+};
+static std::map<GLuint, AttribArrays> attribArrays;
+
+// capabilities, pixel-storage parameters, the clear color and viewport
+static std::map<GLenum, bool> caps;
+static std::map<GLenum, GLint> pixelStore;
+static GLfloat clearColor[4];
+static bool clearColorKnown = false;
+static GLint viewport[4];
+static bool viewportKnown = false;
+
+static StateCounters counters;
+
+static const char* callNames[NUM_STATE_CALLS] = {
+    "use_program", "uniform", "bind_vertex_array", "bind_buffer",
+    "bind_buffer_range", "vertex_attrib_array", "enable", "clear_color",
+    "pixel_store", "viewport"
+};
+
+const char* stateCallName(int call) {
+    return call >= 0 && call < NUM_STATE_CALLS ? callNames[call] : "?";
+}
+
+// count a call of the given kind; returns whether it needs making
+static bool issue(StateCall call, bool needed) {
+    if (needed) counters.issued[call]++;
+    else counters.skipped[call]++;
+    return needed;
+}
+
+//----------------------------------------------------------------------------
+
+void stateUseProgram(GLuint program) {
+    if (!issue(CALL_USE_PROGRAM, !programKnown || program != currentProgram)) return;
+    glUseProgram(program);
+    currentProgram = program;
+    programKnown = true;
+    current = &uniforms[program];
+}
+
+GLuint stateProgram(void) {
+    return currentProgram;
+}
+
+// whether the uniform at 'location' needs setting to the 'size' floats at
+// 'value'; if so, remembers it as set
+static bool changed(GLint location, const GLfloat* value, int size) {
+    if (current == NULL) {
+        // no program through us: nothing to compare against
+        return issue(CALL_UNIFORM, true);
+    }
+    if ((int)current->size() <= location) {
+        UniformSlot unknown = { 0, { 0 } };
+        current->resize(location + 1, unknown);
+    }
+    UniformSlot& slot = (*current)[location];
+    if (slot.size == size && memcmp(slot.value, value, size * sizeof(GLfloat)) == 0) {
+        return issue(CALL_UNIFORM, false);
+    }
+    slot.size = size;
+    memcpy(slot.value, value, size * sizeof(GLfloat));
+    return issue(CALL_UNIFORM, true);
+}
+
+void stateUniform1i(GLint location, GLint value) {
+    if (location < 0) return;
+    GLfloat bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (changed(location, &bits, 1)) glUniform1i(location, value);
+}
+
+void stateUniform4fv(GLint location, const GLfloat* value) {
+    if (location < 0) return;
+    if (changed(location, value, 4)) glUniform4fv(location, 1, value);
+}
+
+void stateUniformMatrix4fv(GLint location, const GLfloat* columns) {
+    if (location < 0) return;
+    if (changed(location, columns, 16)) glUniformMatrix4fv(location, 1, GL_FALSE, columns);
+}
+
+//----------------------------------------------------------------------------
+
+void stateBindVertexArray(GLuint vao) {
+    if (!issue(CALL_BIND_VERTEX_ARRAY, !vaoKnown || vao != currentVao)) return;
+    glBindVertexArray(vao);
+    currentVao = vao;
+    vaoKnown = true;
+}
+
+GLuint stateVertexArray(void) {
+    return currentVao;
+}
+
+void stateBindBuffer(GLenum target, GLuint buffer) {
+    std::map<GLenum, GLuint>::iterator it = buffers.find(target);
+    if (!issue(CALL_BIND_BUFFER, it == buffers.end() || it->second != buffer)) return;
+    glBindBuffer(target, buffer);
+    buffers[target] = buffer;
+}
+
+void stateBindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                          GLintptr offset, GLsizeiptr size) {
+    std::pair<GLenum, GLuint> key(target, index);
+    std::map<std::pair<GLenum, GLuint>, BufferRange>::iterator it = ranges.find(key);
+    bool same = it != ranges.end() && it->second.buffer == buffer &&
+                it->second.offset == offset && it->second.size == size;
+    if (!issue(CALL_BIND_BUFFER_RANGE, !same)) return;
+    glBindBufferRange(target, index, buffer, offset, size);
+    BufferRange range = { buffer, offset, size };
+    ranges[key] = range;
+    buffers[target] = buffer;
+}
+
+void stateDeleteBuffers(GLsizei n, const GLuint* deleted) {
+    glDeleteBuffers(n, deleted);
+    for (GLsizei i = 0; i < n; i++) {
+        // a deleted buffer is unbound from wherever it was bound
+        for (std::map<GLenum, GLuint>::iterator it = buffers.begin(); it != buffers.end(); ++it) {
+            if (it->second == deleted[i]) it->second = 0;
+        }
+        for (std::map<std::pair<GLenum, GLuint>, BufferRange>::iterator it = ranges.begin();
+             it != ranges.end(); ) {
+            if (it->second.buffer == deleted[i]) ranges.erase(it++);
+            else ++it;
+        }
+    }
+}
+
+// enable or disable an attribute array of the bound vertex array object
+static void setAttribArray(GLint index, bool enable) {
+    if (index < 0) return;
+    if (!vaoKnown || index >= 32) {
+        // not something we can remember
+        issue(CALL_VERTEX_ATTRIB_ARRAY, true);
+    }
+    else {
+        AttribArrays& arrays = attribArrays[currentVao];
+        unsigned bit = 1u << index;
+        bool same = (arrays.known & bit) && ((arrays.enabled & bit) != 0) == enable;
+        if (!issue(CALL_VERTEX_ATTRIB_ARRAY, !same)) return;
+        arrays.known |= bit;
+        if (enable) arrays.enabled |= bit;
+        else arrays.enabled &= ~bit;
+    }
+    if (enable) glEnableVertexAttribArray(index);
+    else glDisableVertexAttribArray(index);
+}
+
+void stateEnableVertexAttribArray(GLint index) {
+    setAttribArray(index, true);
+}
+
+void stateDisableVertexAttribArray(GLint index) {
+    setAttribArray(index, false);
+}
+
+//----------------------------------------------------------------------------
+
+// enable or disable a capability
+static void setCap(GLenum cap, bool enable) {
+    std::map<GLenum, bool>::iterator it = caps.find(cap);
+    if (!issue(CALL_ENABLE, it == caps.end() || it->second != enable)) return;
+    if (enable) glEnable(cap);
+    else glDisable(cap);
+    caps[cap] = enable;
+}
+
+void stateEnable(GLenum cap) {
+    setCap(cap, true);
+}
+
+void stateDisable(GLenum cap) {
+    setCap(cap, false);
+}
+
+void stateClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    GLfloat rgba[4] = { red, green, blue, alpha };
+    bool same = clearColorKnown && memcmp(rgba, clearColor, sizeof(rgba)) == 0;
+    if (!issue(CALL_CLEAR_COLOR, !same)) return;
+    glClearColor(red, green, blue, alpha);
+    memcpy(clearColor, rgba, sizeof(rgba));
+    clearColorKnown = true;
+}
+
+void stateGetClearColor(GLfloat* rgba) {
+    if (!clearColorKnown) {
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+        clearColorKnown = true;
+    }
+    memcpy(rgba, clearColor, sizeof(clearColor));
+}
+
+void statePixelStorei(GLenum pname, GLint param) {
+    std::map<GLenum, GLint>::iterator it = pixelStore.find(pname);
+    if (!issue(CALL_PIXEL_STORE, it == pixelStore.end() || it->second != param)) return;
+    glPixelStorei(pname, param);
+    pixelStore[pname] = param;
+}
+
+void stateViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    GLint v[4] = { x, y, width, height };
+    bool same = viewportKnown && memcmp(v, viewport, sizeof(v)) == 0;
+    if (!issue(CALL_VIEWPORT, !same)) return;
+    glViewport(x, y, width, height);
+    memcpy(viewport, v, sizeof(v));
+    viewportKnown = true;
+}
+
+void stateGetViewport(GLint* xywh) {
+    if (!viewportKnown) {
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        viewportKnown = true;
+    }
+    memcpy(xywh, viewport, sizeof(viewport));
+}
+
+//----------------------------------------------------------------------------
+
+void stateForget(void) {
+    uniforms.clear();
+    current = NULL;
+    programKnown = false;
+    vaoKnown = false;
+    buffers.clear();
+    ranges.clear();
+    attribArrays.clear();
+    caps.clear();
+    pixelStore.clear();
+    clearColorKnown = false;
+    viewportKnown = false;
+}
+
+const StateCounters& stateCounters(void) {
+    return counters;
+}
+
+void stateResetCounters(void) {
+    memset(&counters, 0, sizeof(counters));
+}
+
+void statePrintCounters(std::ostream& os) {
+    int order[NUM_STATE_CALLS];
+    for (int i = 0; i < NUM_STATE_CALLS; i++) order[i] = i;
+    std::stable_sort(order, order + NUM_STATE_CALLS, [](int a, int b) {
+        return counters.issued[a] + counters.skipped[a] >
+               counters.issued[b] + counters.skipped[b];
+    });
+    for (int i = 0; i < NUM_STATE_CALLS; i++) {
+        int call = order[i];
+        if (counters.issued[call] + counters.skipped[call] == 0) continue;
+        os << stateCallName(call) << ": " << counters.issued[call] << " issued, "
+           << counters.skipped[call] << " skipped" << std::endl;
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * OpenGL state tracking: a thin layer over the OpenGL calls that change
+ * state, which remembers what has been set, so that setting something to
+ * the value it already has costs no driver call.  Every call through it
+ * is counted, by kind, as issued or skipped, which also shows which state
+ * changes a frame makes most.
+ *
+ * Uniform values are remembered per program and location.  Matrices are
+ * taken column by column (already transposed from our row-major mat4),
+ * so they go to the driver as they are, with no transpose flag.  Which
+ * vertex attribute arrays are enabled is remembered per vertex array
+ * object, as OpenGL keeps it.
+ *
+ * The tracker only knows about changes made through it: anything that
+ * changes state behind its back should call stateForget().
+ */
+
+#ifndef __GL_STATE_H__
+#define __GL_STATE_H__
+
+#include "cs432.h"
+
+// the kinds of call the tracker counts
+enum StateCall {
+    CALL_USE_PROGRAM,
+    CALL_UNIFORM,
+    CALL_BIND_VERTEX_ARRAY,
+    CALL_BIND_BUFFER,
+    CALL_BIND_BUFFER_RANGE,
+    CALL_VERTEX_ATTRIB_ARRAY, // enabling or disabling one
+    CALL_ENABLE,              // glEnable or glDisable
+    CALL_CLEAR_COLOR,
+    CALL_PIXEL_STORE,
+    CALL_VIEWPORT,
+    NUM_STATE_CALLS
+};
+
+// what the tracker has passed on to OpenGL, and what it has not, by kind
+struct StateCounters {
+    long issued[NUM_STATE_CALLS];
+    long skipped[NUM_STATE_CALLS];
+};
+
+// a short name for a kind of call, e.g., "bind_buffer"
+const char* stateCallName(int call);
+
+// make 'program' current (if it is not already)
+void stateUseProgram(GLuint program);
+
+// the program made current through the tracker, or 0
+GLuint stateProgram(void);
+
+// set a uniform of the current program, unless it already has the value;
+// a negative location (a uniform the program does not use) is ignored
+void stateUniform1i(GLint location, GLint value);
+void stateUniform4fv(GLint location, const GLfloat* value);
+
+// the same, for a mat4 given column by column (see transpose() in mat.h)
+void stateUniformMatrix4fv(GLint location, const GLfloat* columns);
+
+// bind a vertex array object, or a buffer to a (non-indexed) target
+void stateBindVertexArray(GLuint vao);
+void stateBindBuffer(GLenum target, GLuint buffer);
+
+// the vertex array object bound through the tracker, or 0
+GLuint stateVertexArray(void);
+
+// bind part of a buffer to an indexed target (e.g., a uniform buffer
+// binding point); this binds it to the target itself as well
+void stateBindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                          GLintptr offset, GLsizeiptr size);
+
+// delete buffers, forgetting any binding of them
+void stateDeleteBuffers(GLsizei n, const GLuint* buffers);
+
+// enable or disable a vertex attribute array of the bound vertex array
+// object; a negative index (an attribute the program does not use) is
+// ignored
+void stateEnableVertexAttribArray(GLint index);
+void stateDisableVertexAttribArray(GLint index);
+
+// enable or disable a capability, e.g., GL_DEPTH_TEST
+void stateEnable(GLenum cap);
+void stateDisable(GLenum cap);
+
+// set the clear color, and get it back (asking OpenGL only if it was
+// never set through the tracker)
+void stateClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void stateGetClearColor(GLfloat* rgba);
+
+// set a pixel-storage parameter, e.g., GL_PACK_ALIGNMENT
+void statePixelStorei(GLenum pname, GLint param);
+
+// set the viewport, and get it back (as stateGetClearColor)
+void stateViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void stateGetViewport(GLint* xywh);
+
+// forget everything remembered, e.g., after a new program is linked
+void stateForget(void);
+
+// the counts since the last stateResetCounters()
+const StateCounters& stateCounters(void);
+void stateResetCounters(void);
+
+// print the counts, one kind of call per line, busiest first
+void statePrintCounters(std::ostream& os);
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * Headless rendering: an OpenGL context with no window and no display
+ * server, rendering into an off-screen framebuffer.
+ */
+
+#include "cs432.h"
+#include "headless.h"
+#include "glState.h"
+#include <stdio.h>
+#include <vector>
+
+#ifdef __linux__
+#  include <EGL/egl.h>
+#  include <EGL/eglext.h>
+
+static EGLDisplay display = EGL_NO_DISPLAY;
+static EGLContext context = EGL_NO_CONTEXT;
+#endif
+
+// the off-screen framebuffer and its attachments
+static GLuint framebuffer, colorBuffer, depthBuffer;
+
+#ifdef __linux__
+// get the surfaceless display if the driver offers one, otherwise the
+// default display
+static EGLDisplay getDisplay(void) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay != NULL) {
+        EGLDisplay d = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                          EGL_DEFAULT_DISPLAY, NULL);
+        if (d != EGL_NO_DISPLAY) return d;
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+// report why a context could not be made, and release what was set up
+// on the way; returns false
+static bool createFailed(const char* why) {
+    std::cerr << "headless: " << why << std::endl;
+    if (context != EGL_NO_CONTEXT) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        context = EGL_NO_CONTEXT;
+    }
+    eglTerminate(display);
+    display = EGL_NO_DISPLAY;
+    return false;
+}
+
+bool headlessCreateContext(int width, int height) {
+    display = getDisplay();
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+        std::cerr << "headless: no EGL display available" << std::endl;
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        return createFailed("EGL cannot create desktop OpenGL contexts");
+    }
+
+    // we never draw to an EGL surface, so any OpenGL-capable config will do
+    const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = NULL;
+    EGLint numConfigs = 0;
+    eglChooseConfig(display, configAttribs, &config, 1, &numConfigs);
+
+    context = eglCreateContext(display, numConfigs > 0 ? config : NULL,
+                               EGL_NO_CONTEXT, NULL);
+    if (context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        return createFailed("could not create a surfaceless context");
+    }
+    glewInit();
+
+    // render into a framebuffer object in place of a window
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              GL_RENDERBUFFER, colorBuffer);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                              GL_RENDERBUFFER, depthBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        glDeleteRenderbuffers(1, &depthBuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+        return createFailed("off-screen framebuffer is incomplete");
+    }
+
+    std::cout << "headless: " << glGetString(GL_RENDERER)
+              << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+    return true;
+}
+
+void headlessDestroyContext(void) {
+    if (context == EGL_NO_CONTEXT) return;
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+    eglTerminate(display);
+    context = EGL_NO_CONTEXT;
+    display = EGL_NO_DISPLAY;
+}
+
+#else // no EGL on this platform
+
+bool headlessCreateContext(int, int) {
+    std::cerr << "headless: not supported on this platform" << std::endl;
+    return false;
+}
+
+void headlessDestroyContext(void) {
+}
+
+#endif
+
+bool headlessWritePng(const char* filename, int width, int height) {
+    std::vector<unsigned char> pixels((size_t)width * height * 4);
+    statePixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+    return writePng(filename, width, height, &pixels[0]);
+}
+
+//----------------------------------------------------------------------------
+//  PNG output.  The image data is stored, not compressed, which keeps this
+//  free of any library at the cost of larger files.
+//----------------------------------------------------------------------------
+
+// CRC-32, as used for each PNG chunk
+static unsigned long crc32(unsigned long crc, const unsigned char* buf, size_t len) {
+    static unsigned long table[256];
+    static bool haveTable = false;
+    if (!haveTable) {
+        for (unsigned long n = 0; n < 256; n++) {
+            unsigned long c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        haveTable = true;
+    }
+    crc ^= 0xffffffffUL;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffUL;
+}
+
+// append a 32-bit big-endian value
+static void put32(std::vector<unsigned char>& out, unsigned long v) {
+    out.push_back((unsigned char)(v >> 24));
+    out.push_back((unsigned char)(v >> 16));
+    out.push_back((unsigned char)(v >> 8));
+    out.push_back((unsigned char)v);
+}
+
+// write one chunk: length, type, data, CRC over type and data; returns
+// false if it could not all be written
+static bool writeChunk(FILE* fp, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    put32(chunk, (unsigned long)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    put32(chunk, crc32(0, &chunk[4], chunk.size() - 4));
+    return fwrite(&chunk[0], 1, chunk.size(), fp) == chunk.size();
+}
+
+bool writePng(const char* filename, int width, int height, const unsigned char* rgba) {
+    FILE* fp = NULL;
+    fopen_s(&fp, filename, "wb");
+    if (fp == NULL) return false;
+
+    static const unsigned char signature[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+    bool ok = fwrite(signature, 1, 8, fp) == 8;
+
+    // header: size, 8 bits per channel, RGBA, no interlacing
+    std::vector<unsigned char> header;
+    put32(header, width);
+    put32(header, height);
+    header.push_back(8);
+    header.push_back(6);
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    ok = ok && writeChunk(fp, "IHDR", header);
+
+    // raw scanlines, top row first, each preceded by filter type 0
+    size_t rowSize = (size_t)width * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowSize + 1) * height);
+    for (int y = height - 1; y >= 0; y--) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + y * rowSize, rgba + (y + 1) * rowSize);
+    }
+
+    // zlib stream made of "stored" deflate blocks, then an Adler-32 checksum
+    std::vector<unsigned char> z;
+    z.push_back(0x78);
+    z.push_back(0x01);
+    size_t pos = 0;
+    do {
+        size_t len = raw.size() - pos;
+        if (len > 65535) len = 65535;
+        z.push_back(pos + len == raw.size() ? 1 : 0);
+        z.push_back((unsigned char)len);
+        z.push_back((unsigned char)(len >> 8));
+        z.push_back((unsigned char)~len);
+        z.push_back((unsigned char)(~len >> 8));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+    unsigned long a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32(z, (b << 16) | a);
+    ok = ok && writeChunk(fp, "IDAT", z);
+
+    ok = ok && writeChunk(fp, "IEND", std::vector<unsigned char>());
+
+    // a full disk may only show when the buffered data is flushed
+    if (fclose(fp) != 0) ok = false;
+    return ok;
+}
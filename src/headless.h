@@ -0,0 +1,30 @@
+/*
+ * Headless rendering: an OpenGL context with no window and no display
+ * server, rendering into an off-screen framebuffer.
+ *
+ * On Linux this uses a surfaceless EGL display, which Mesa provides even
+ * on machines without a GPU (the llvmpipe software rasterizer).  On other
+ * platforms headlessCreateContext() reports failure.
+ */
+
+#ifndef __HEADLESS_H__
+#define __HEADLESS_H__
+
+// create a context and make it current, with a width x height framebuffer
+// (color and depth) bound for drawing; returns false (after printing why)
+// if that is not possible
+bool headlessCreateContext(int width, int height);
+
+// release the framebuffer and the context
+void headlessDestroyContext(void);
+
+// read the current framebuffer and write it to a PNG file; returns false
+// if the file could not be written
+bool headlessWritePng(const char* filename, int width, int height);
+
+// write an RGBA image, given bottom row first (as glReadPixels returns it),
+// to an uncompressed PNG file; returns false if it could not all be written
+bool writePng(const char* filename, int width, int height,
+              const unsigned char* rgba);
+
+#endif
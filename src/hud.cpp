@@ -0,0 +1,279 @@
+/*
+ * Performance HUD: frame rate, frame-time graph and per-frame costs,
+ * drawn in one draw call with the scene's stroke font.
+ */
+
+#include "cs432.h"
+#include "hud.h"
+#include "characters.h"
+#include "glState.h"
+#include "picking.h"
+#include "scene.h"
+#include "streamBuffer.h"
+#include <cstddef>
+#include <stdio.h>
+#include <vector>
+
+// one HUD vertex: where it goes, in pixels from the top-left corner of
+// the viewport, and its color
+struct HudVertex {
+    GLfloat x, y;
+    GLubyte color[4];
+};
+
+// the most vertices in one frame's HUD (anything more is left out)
+static const int MAX_VERTICES = 16384;
+
+// frame times kept for the graph, and the seconds the frame rate is
+// averaged over
+static const int HISTORY = 128;
+static const double FPS_WINDOW = 0.5;
+
+// the layout, in pixels; the graph's top is a 30 frames/s frame
+static const GLfloat MARGIN = 8, PADDING = 6;
+static const GLfloat TEXT_HEIGHT = 12, LINE_HEIGHT = 18;
+static const GLfloat BAR_WIDTH = 2, GRAPH_HEIGHT = 48;
+static const double GRAPH_TOP = 1.0 / 30;
+static const int LINES = 6, LINE_CHARS = 18;
+
+// the glyphs, in the units characters.h draws them in: a capital runs
+// from GLYPH_BOTTOM up GLYPH_HEIGHT, and each character is centered in
+// GLYPH_ADVANCE.  Small text needs few pieces to an arc.
+static const GLfloat GLYPH_BOTTOM = -1.15, GLYPH_HEIGHT = 2.2, GLYPH_ADVANCE = 2.0;
+static const int GLYPH_ARC_DIVISIONS = 8;
+
+static const GLubyte PANEL_COLOR[4] = { 0, 0, 0, 160 };
+static const GLubyte TEXT_COLOR[4] = { 255, 255, 255, 255 };
+static const GLubyte LINE_COLOR[4] = { 128, 128, 128, 255 };
+static const GLubyte FAST_COLOR[4] = { 64, 224, 64, 255 };   // 60 frames/s or better
+static const GLubyte SLOW_COLOR[4] = { 240, 208, 32, 255 };  // 30 or better
+static const GLubyte STALL_COLOR[4] = { 240, 48, 48, 255 };  // worse
+
+// each glyph's front faces, flattened: the corners of its triangles
+static std::vector<vec2> glyphCorners;
+static int glyphStart[128], glyphCount[128];
+
+static bool ready = false, visible = false;
+static GLuint hudProgram, hudVao;
+static GLint Transform;
+static StreamBuffer hudStream;
+
+// the recent frame times, oldest first from 'historyNext', and the
+// latest frame's costs
+static float frameTimes[HISTORY];
+static int historyNext = 0, historyCount = 0;
+static DrawStats lastDraws = { 0, 0 };
+static CullStats lastCull = { 0, 0 };
+static long lastUniforms = 0, uniformsBefore = 0;
+
+//----------------------------------------------------------------------------
+
+// keep the triangles of a generated character that lie wholly on its
+// front face
+static void addGlyph(int c) {
+    Mesh mesh;
+    genCharacter(mesh, (char)c, vec4(1, 1, 1, 1), 0.3, 0.2, 0, GLYPH_ARC_DIVISIONS);
+    glyphStart[c] = (int)glyphCorners.size();
+    for (int i = 0; i + 2 < mesh.size(); i += 3) {
+        if (mesh[i].point.z <= 0 || mesh[i + 1].point.z <= 0 || mesh[i + 2].point.z <= 0) {
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            glyphCorners.push_back(vec2(mesh[i + k].point.x, mesh[i + k].point.y));
+        }
+    }
+    glyphCount[c] = (int)glyphCorners.size() - glyphStart[c];
+}
+
+bool hudInit(void) {
+    for (int c = '!'; c <= '~'; c++) {
+        addGlyph(c);
+    }
+    if (!hudStream.init(MAX_VERTICES * sizeof(HudVertex))) {
+        return false;
+    }
+
+    // positions arrive in pixels; Transform takes them to clip coordinates
+    const GLchar* vShaderCode =
+        "attribute vec2 vPosition; "
+        "attribute vec4 vColor; "
+        "uniform vec4 Transform; "
+        "varying vec4 color; "
+        "void main() "
+        "{ "
+        "  gl_Position = vec4(vPosition * Transform.xy + Transform.zw, 0.0, 1.0); "
+        "  color = vColor; "
+        "} ";
+    const GLchar* fShaderCode =
+        "varying vec4 color; "
+        "void main() "
+        "{ "
+        "  gl_FragColor = color; "
+        "} ";
+    GLuint sceneProgram = stateProgram();
+    GLuint sceneVao = stateVertexArray();
+    hudProgram = InitShader2(vShaderCode, fShaderCode);
+    Transform = glGetUniformLocation(hudProgram, "Transform");
+
+    glGenVertexArrays(1, &hudVao);
+    stateBindVertexArray(hudVao);
+    stateBindBuffer(GL_ARRAY_BUFFER, hudStream.buffer());
+    GLint vPosition = glGetAttribLocation(hudProgram, "vPosition");
+    GLint vColor = glGetAttribLocation(hudProgram, "vColor");
+    stateEnableVertexAttribArray(vPosition);
+    glVertexAttribPointer(vPosition, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex),
+        BUFFER_OFFSET(offsetof(HudVertex, x)));
+    stateEnableVertexAttribArray(vColor);
+    glVertexAttribPointer(vColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HudVertex),
+        BUFFER_OFFSET(offsetof(HudVertex, color)));
+
+    stateBindVertexArray(sceneVao);
+    stateUseProgram(sceneProgram);
+    ready = true;
+    return true;
+}
+
+bool hudSetVisible(bool on) {
+    visible = on && ready;
+    return visible;
+}
+
+bool hudVisible(void) {
+    return visible;
+}
+
+void hudRecordFrame(double frameTime, const CullStats& cull) {
+    frameTimes[historyNext] = (float)frameTime;
+    historyNext = (historyNext + 1) % HISTORY;
+    if (historyCount < HISTORY) historyCount++;
+
+    lastDraws = sceneDrawStats();
+    lastCull = cull;
+
+    // the tracker's counts only grow, until someone resets them
+    long uniforms = stateCounters().issued[CALL_UNIFORM];
+    lastUniforms = uniforms >= uniformsBefore ? uniforms - uniformsBefore : uniforms;
+    uniformsBefore = uniforms;
+}
+
+//----------------------------------------------------------------------------
+
+// where this frame's vertices go
+class HudWriter {
+    HudVertex* _vertices;
+    int _count;
+
+    void vertex(GLfloat x, GLfloat y, const GLubyte* color) {
+        HudVertex& v = _vertices[_count++];
+        v.x = x;
+        v.y = y;
+        for (int i = 0; i < 4; i++) v.color[i] = color[i];
+    }
+
+public:
+    explicit HudWriter(void* vertices): _vertices((HudVertex*)vertices), _count(0) { }
+
+    int count(void) const { return _count; }
+
+    // a rectangle, from (x0, y0) to (x1, y1)
+    void rect(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, const GLubyte* color) {
+        if (_count + 6 > MAX_VERTICES) return;
+        vertex(x0, y0, color); vertex(x1, y0, color); vertex(x1, y1, color);
+        vertex(x0, y0, color); vertex(x1, y1, color); vertex(x0, y1, color);
+    }
+
+    // a line of text, with its first character's bottom-left corner at
+    // (x, y)
+    void text(GLfloat x, GLfloat y, const char* s, const GLubyte* color) {
+        GLfloat scale = TEXT_HEIGHT / GLYPH_HEIGHT;
+        for (; *s != '\0'; s++, x += GLYPH_ADVANCE * scale) {
+            int c = (unsigned char)*s;
+            if (c < '!' || c > '~' || glyphCount[c] == 0) continue;
+            if (_count + glyphCount[c] > MAX_VERTICES) return;
+            GLfloat centerX = x + GLYPH_ADVANCE * scale / 2;
+            const vec2* corner = &glyphCorners[glyphStart[c]];
+            for (int i = 0; i < glyphCount[c]; i++) {
+                vertex(centerX + corner[i].x * scale,
+                       y - (corner[i].y - GLYPH_BOTTOM) * scale, color);
+            }
+        }
+    }
+};
+
+// frames per second, over the last FPS_WINDOW seconds of frames
+static double framesPerSecond(void) {
+    double total = 0;
+    int frames = 0;
+    while (frames < historyCount && total < FPS_WINDOW) {
+        total += frameTimes[(historyNext - 1 - frames + HISTORY) % HISTORY];
+        frames++;
+    }
+    return total > 0 ? frames / total : 0;
+}
+
+void hudDraw(void) {
+    if (!visible) return;
+
+    GLint viewport[4];
+    stateGetViewport(viewport);
+    GLfloat charWidth = GLYPH_ADVANCE * TEXT_HEIGHT / GLYPH_HEIGHT;
+    GLfloat width = LINE_CHARS * charWidth > HISTORY * BAR_WIDTH ?
+                    LINE_CHARS * charWidth : HISTORY * BAR_WIDTH;
+    GLfloat left = MARGIN + PADDING, top = MARGIN + PADDING;
+    GLfloat graphTop = top + LINES * LINE_HEIGHT + PADDING;
+
+    HudWriter out(hudStream.begin());
+    out.rect(MARGIN, MARGIN, left + width + PADDING,
+             graphTop + GRAPH_HEIGHT + PADDING, PANEL_COLOR);
+
+    // the numbers
+    char lines[LINES][64];
+    double fps = framesPerSecond();
+    snprintf(lines[0], sizeof(lines[0]), "%.1f FPS %.2f ms", fps, fps > 0 ? 1000 / fps : 0);
+    snprintf(lines[1], sizeof(lines[1]), "draws %d", lastDraws.drawCalls);
+    snprintf(lines[2], sizeof(lines[2]), "tris %ld", lastDraws.triangles);
+    snprintf(lines[3], sizeof(lines[3]), "uniforms %ld", lastUniforms);
+    snprintf(lines[4], sizeof(lines[4]), "culled %d/%d", lastCull.culled, lastCull.tested);
+    if (pickLatency() >= 0) {
+        snprintf(lines[5], sizeof(lines[5]), "pick %.2f ms", pickLatency() * 1000);
+    }
+    else {
+        snprintf(lines[5], sizeof(lines[5]), "pick -");
+    }
+    for (int i = 0; i < LINES; i++) {
+        out.text(left, top + (i + 1) * LINE_HEIGHT - (LINE_HEIGHT - TEXT_HEIGHT) / 2,
+                 lines[i], TEXT_COLOR);
+    }
+
+    // the frame times, newest on the right, with a line at 60 frames/s
+    GLfloat graphBottom = graphTop + GRAPH_HEIGHT;
+    GLfloat x = left + (HISTORY - historyCount) * BAR_WIDTH;
+    for (int i = 0; i < historyCount; i++, x += BAR_WIDTH) {
+        double t = frameTimes[(historyNext - historyCount + i + HISTORY) % HISTORY];
+        double h = t < GRAPH_TOP ? t / GRAPH_TOP : 1;
+        const GLubyte* color = t <= 1.0 / 58 ? FAST_COLOR :
+                               t <= 1.0 / 29 ? SLOW_COLOR : STALL_COLOR;
+        out.rect(x, graphBottom - (GLfloat)(h * GRAPH_HEIGHT), x + BAR_WIDTH - 0.5f,
+                 graphBottom, color);
+    }
+    GLfloat sixty = graphBottom - (GLfloat)(1.0 / 60 / GRAPH_TOP * GRAPH_HEIGHT);
+    out.rect(left, sixty, left + HISTORY * BAR_WIDTH, sixty + 1, LINE_COLOR);
+
+    // all of it in one draw, over the frame
+    GLint first = (GLint)(hudStream.end(out.count() * sizeof(HudVertex)) / sizeof(HudVertex));
+    GLuint sceneProgram = stateProgram();
+    GLuint sceneVao = stateVertexArray();
+    stateUseProgram(hudProgram);
+    GLfloat transform[4] = { 2.0f / viewport[2], -2.0f / viewport[3], -1, 1 };
+    stateUniform4fv(Transform, transform);
+    stateBindVertexArray(hudVao);
+    stateDisable(GL_DEPTH_TEST);
+    stateEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLES, first, out.count());
+    hudStream.fence();
+    stateDisable(GL_BLEND);
+    stateEnable(GL_DEPTH_TEST);
+    stateBindVertexArray(sceneVao);
+    stateUseProgram(sceneProgram);
+}
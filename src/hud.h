@@ -0,0 +1,38 @@
+/*
+ * Performance HUD: an overlay, drawn over the finished frame, showing the
+ * frame rate, a graph of recent frame times, and what each frame cost:
+ * draw calls, triangles submitted, uniform uploads, objects culled, and
+ * how long the last pick took.  It lets performance be watched live,
+ * with no profiler attached.
+ *
+ * The text uses the same stroke font as the scene (see characters.h):
+ * only the front faces of the glyphs, flattened to the screen.  Every
+ * frame the text, the graph and the panel behind them are written into
+ * one streaming buffer and drawn with a single draw call.
+ */
+
+#ifndef __HUD_H__
+#define __HUD_H__
+
+#include "cull.h"
+
+// build the glyphs and set up the shader and buffers; requires a current
+// OpenGL context.  Returns false (after printing why) if it cannot.
+bool hudInit(void);
+
+// show or hide the HUD (it is hidden at first); returns whether it is
+// now shown
+bool hudSetVisible(bool on);
+bool hudVisible(void);
+
+// record a frame just drawn: the seconds since the frame before it, and
+// the objects it culled.  The rest (draw calls, triangles, uniform
+// uploads, pick latency) is read from the scene, the state tracker and
+// the picking code.
+void hudRecordFrame(double frameTime, const CullStats& cull);
+
+// draw the HUD over the current frame, if it is shown, in the top-left
+// corner of the viewport
+void hudDraw(void);
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Input recording and replay: a log of the keys pressed, the mouse clicks
+ * and the picks they led to, each stamped with the simulation step it
+ * came before.
+ */
+
+#include "cs432.h"
+#include "inputLog.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static const char MAGIC[4] = { 'P', 'I', 'G', 'R' };
+static const int HEADER_SIZE = 16;
+static const int EVENT_SIZE = 12;
+
+static uint32_t tick = 0;
+
+// recording
+static FILE* recordFile = NULL;
+
+// replay: the whole log, and the next event to hand out
+static std::vector<InputEvent> replayEvents;
+static size_t nextEvent = 0;
+static bool replaying = false;
+
+uint32_t inputTick(void) {
+    return tick;
+}
+
+void inputStep(void) {
+    tick++;
+}
+
+static inline void writeU16(unsigned char* p, int v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static inline void writeU32(unsigned char* p, uint32_t v) {
+    writeU16(p, (int)(v & 0xffff));
+    writeU16(p + 2, (int)(v >> 16));
+}
+
+static inline int readS16(const unsigned char* p) {
+    return (int16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readU32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// the step length, as stored
+static uint32_t stepMicroseconds(double step) {
+    return (uint32_t)floor(step * 1e6 + 0.5);
+}
+
+//----------------------------------------------------------------------------
+
+bool inputStartRecording(const char* filename, uint64_t seed, double step) {
+    inputStopRecording();
+    fopen_s(&recordFile, filename, "wb");
+    if (recordFile == NULL) return false;
+    unsigned char header[HEADER_SIZE];
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    writeU32(header + 4, stepMicroseconds(step));
+    writeU32(header + 8, (uint32_t)seed);
+    writeU32(header + 12, (uint32_t)(seed >> 32));
+    fwrite(header, 1, HEADER_SIZE, recordFile);
+
+    static bool registered = false;
+    if (!registered) {
+        atexit(inputStopRecording);
+        registered = true;
+    }
+    return true;
+}
+
+void inputRecord(InputEventType type, int code, int state, int x, int y) {
+    if (recordFile == NULL) return;
+    unsigned char event[EVENT_SIZE];
+    writeU32(event, tick);
+    event[4] = (unsigned char)type;
+    event[5] = (unsigned char)code;
+    event[6] = (unsigned char)state;
+    event[7] = 0;
+    writeU16(event + 8, x);
+    writeU16(event + 10, y);
+    fwrite(event, 1, EVENT_SIZE, recordFile);
+}
+
+void inputRecordCheck(uint32_t checksum) {
+    if (recordFile == NULL) return;
+    unsigned char event[EVENT_SIZE];
+    writeU32(event, tick);
+    event[4] = (unsigned char)INPUT_CHECK;
+    event[5] = event[6] = event[7] = 0;
+    writeU32(event + 8, checksum);
+    fwrite(event, 1, EVENT_SIZE, recordFile);
+}
+
+void inputStopRecording(void) {
+    if (recordFile == NULL) return;
+    inputRecord(INPUT_END, 0);
+    fclose(recordFile);
+    recordFile = NULL;
+}
+
+//----------------------------------------------------------------------------
+
+bool inputStartReplay(const char* filename, double step, uint64_t& seed) {
+    FILE* fp = NULL;
+    fopen_s(&fp, filename, "rb");
+    if (fp == NULL) {
+        std::cerr << "replay: cannot read " << filename << std::endl;
+        return false;
+    }
+    unsigned char header[HEADER_SIZE];
+    if (fread(header, 1, HEADER_SIZE, fp) != (size_t)HEADER_SIZE
+        || memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "replay: " << filename << " is not an input log" << std::endl;
+        fclose(fp);
+        return false;
+    }
+    if (readU32(header + 4) != stepMicroseconds(step)) {
+        std::cerr << "replay: " << filename << " was recorded with a "
+                  << readU32(header + 4) << " us step, not "
+                  << stepMicroseconds(step) << " us" << std::endl;
+        fclose(fp);
+        return false;
+    }
+    seed = readU32(header + 8) | ((uint64_t)readU32(header + 12) << 32);
+
+    replayEvents.clear();
+    unsigned char bytes[EVENT_SIZE];
+    while (fread(bytes, 1, EVENT_SIZE, fp) == (size_t)EVENT_SIZE) {
+        InputEvent e;
+        e.tick = readU32(bytes);
+        e.type = bytes[4];
+        e.code = bytes[5];
+        e.state = bytes[6];
+        e.x = readS16(bytes + 8);
+        e.y = readS16(bytes + 10);
+        e.checksum = e.type == INPUT_CHECK ? readU32(bytes + 8) : 0;
+        replayEvents.push_back(e);
+        if (e.type == INPUT_END) break;
+    }
+    fclose(fp);
+
+    // a log cut short (the program was killed) ends after its last event
+    if (replayEvents.empty() || replayEvents.back().type != INPUT_END) {
+        InputEvent end = { replayEvents.empty() ? 0 : replayEvents.back().tick,
+                           INPUT_END, 0, 0, 0, 0, 0 };
+        replayEvents.push_back(end);
+    }
+    nextEvent = 0;
+    tick = 0;
+    replaying = true;
+    return true;
+}
+
+bool inputNextEvent(InputEvent& event) {
+    if (!replaying || nextEvent >= replayEvents.size()) return false;
+    const InputEvent& e = replayEvents[nextEvent];
+    if (e.type == INPUT_END || e.tick > tick) return false;
+    event = e;
+    nextEvent++;
+    return true;
+}
+
+bool inputReplaying(void) {
+    return replaying;
+}
+
+bool inputReplayDone(void) {
+    return replaying && nextEvent < replayEvents.size()
+        && replayEvents[nextEvent].type == INPUT_END
+        && tick >= replayEvents[nextEvent].tick;
+}
@@ -0,0 +1,82 @@
+/*
+ * Input recording and replay: a log of the keys pressed, the mouse clicks
+ * and the picks they led to, each stamped with the simulation step it
+ * came before, so that a session can be played again exactly.
+ *
+ * The simulation runs in fixed steps (see frameClock.h) and the game's
+ * random numbers come from the seed, which the log records; so applying
+ * the same input before the same steps gives the same game, however fast
+ * the replay runs and however many frames it draws.  That makes a
+ * recorded session a repeatable workload for profiling and comparing
+ * builds.
+ *
+ * A pick is logged as its result (what was clicked) rather than replayed
+ * from the click: which object lies under a pixel depends on the window
+ * and on when the picking frame happened to be drawn.  The clicks
+ * themselves are logged too, for reference.
+ *
+ * Every so often the recording also logs a checksum of the game's state
+ * (see gameChecksum()); a replay compares its own, so a replay that has
+ * drifted from its recording (a different build rounding the physics
+ * differently, say) is caught at the step where it first differs.
+ *
+ * The file is a 16-byte header ("PIGR", the step length in microseconds,
+ * the seed) followed by 12-byte events, numbers little-endian (a
+ * checksum takes the place of x and y); the last event is INPUT_END.
+ */
+
+#ifndef __INPUT_LOG_H__
+#define __INPUT_LOG_H__
+
+#include <stdint.h>
+
+enum InputEventType {
+    INPUT_KEY = 0,   // code: the key; x, y: the mouse position
+    INPUT_MOUSE = 1, // code: the button; state: GLUT_DOWN or GLUT_UP; x, y
+    INPUT_PICK = 2,  // code: the pick code passed to the picking callback
+    INPUT_END = 3,   // the session ended
+    INPUT_CHECK = 4  // checksum: the game's state after 'tick' steps
+};
+
+struct InputEvent {
+    uint32_t tick;   // simulation steps taken before it
+    int type;        // InputEventType
+    int code;
+    int state;
+    int x, y;
+    uint32_t checksum;
+};
+
+// the simulation steps taken so far; the main program calls inputStep()
+// after each one
+uint32_t inputTick(void);
+void inputStep(void);
+
+// start writing a log, for a game seeded with 'seed' and stepped every
+// 'step' seconds; the log is finished when the program exits.  Returns
+// false if the file cannot be written.
+bool inputStartRecording(const char* filename, uint64_t seed, double step);
+
+// log an event at the current tick, if recording
+void inputRecord(InputEventType type, int code, int state = 0, int x = 0, int y = 0);
+
+// log a checksum of the game's state at the current tick, if recording
+void inputRecordCheck(uint32_t checksum);
+
+// finish the log (writing INPUT_END) and close it
+void inputStopRecording(void);
+
+// read a log to replay; its seed is returned.  Returns false (after
+// printing why) if it cannot be read, or was recorded with a different
+// step length.
+bool inputStartReplay(const char* filename, double step, uint64_t& seed);
+
+// the next event logged for the current tick, if there is one (and the
+// log has not ended)
+bool inputNextEvent(InputEvent& event);
+
+// is a replay running?  Has it reached the end of its log?
+bool inputReplaying(void);
+bool inputReplayDone(void);
+
+#endif
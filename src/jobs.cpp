@@ -0,0 +1,161 @@
+/*
+ * Job system: runs independent pieces of work on a pool of worker threads.
+ */
+
+#include "jobs.h"
+#include <stdlib.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// one piece of a parallelFor
+struct Job {
+    jobFunction* fcn;
+    void* data;
+    int begin, end;
+    std::atomic<int>* remaining; // pieces of its parallelFor not yet done
+};
+
+// a thread's jobs: it works from the back, thieves take from the front
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<Job> jobs;
+};
+
+// the worker threads, and every thread's queue (queue 0 belongs to the
+// thread that called jobsInit, and to any other thread not ours)
+static std::vector<std::thread> threads;
+static std::vector<WorkQueue*> queues(1, new WorkQueue);
+static thread_local int myQueue = 0;
+
+// idle workers sleep until there are queued jobs, or until shutdown
+static std::mutex wakeLock;
+static std::condition_variable wake;
+static std::atomic<int> queued(0);
+static bool stopping = false;
+
+// take a job from the back of our own queue
+static bool popOwn(Job& job) {
+    WorkQueue& q = *queues[myQueue];
+    std::lock_guard<std::mutex> guard(q.lock);
+    if (q.jobs.empty()) return false;
+    job = q.jobs.back();
+    q.jobs.pop_back();
+    queued--;
+    return true;
+}
+
+// take a job from the front of another thread's queue, trying each in turn
+static bool steal(Job& job) {
+    int n = (int)queues.size();
+    for (int i = 1; i < n; i++) {
+        WorkQueue& q = *queues[(myQueue + i) % n];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.jobs.empty()) continue;
+        job = q.jobs.front();
+        q.jobs.pop_front();
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+static bool findJob(Job& job) {
+    return queued > 0 && (popOwn(job) || steal(job));
+}
+
+static void runJob(const Job& job) {
+    job.fcn(job.data, job.begin, job.end);
+    job.remaining->fetch_sub(1, std::memory_order_release);
+}
+
+static void workerMain(int index) {
+    myQueue = index;
+    for (;;) {
+        Job job;
+        if (findJob(job)) {
+            runJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(wakeLock);
+        wake.wait(guard, [] { return stopping || queued > 0; });
+        if (stopping) return;
+    }
+}
+
+void jobsInit(int workers) {
+    jobsShutdown();
+    if (workers < 0) {
+        workers = (int)std::thread::hardware_concurrency() - 1;
+        if (workers < 0) workers = 0;
+    }
+    stopping = false;
+    static bool registered = false;
+    if (!registered) {
+        atexit(jobsShutdown); // joinable threads must not outlive main
+        registered = true;
+    }
+    while ((int)queues.size() < workers + 1) queues.push_back(new WorkQueue);
+    for (int i = 1; i <= workers; i++) {
+        threads.push_back(std::thread(workerMain, i));
+    }
+}
+
+void jobsShutdown(void) {
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    threads.clear();
+}
+
+int jobsWorkers(void) {
+    return (int)threads.size();
+}
+
+void parallelFor(int count, int grain, jobFunction* fcn, void* data) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    // not worth splitting up (or no one to share with): just do it
+    if (threads.empty() || count <= grain) {
+        fcn(data, 0, count);
+        return;
+    }
+
+    // queue the pieces on our own queue, for us and for thieves
+    int pieces = (count + grain - 1) / grain;
+    std::atomic<int> remaining(pieces);
+    {
+        WorkQueue& q = *queues[myQueue];
+        std::lock_guard<std::mutex> guard(q.lock);
+        for (int begin = 0; begin < count; begin += grain) {
+            Job job = { fcn, data, begin, begin + grain < count ? begin + grain : count,
+                        &remaining };
+            q.jobs.push_back(job);
+        }
+        queued += pieces;
+    }
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+    }
+    wake.notify_all();
+
+    // work (on these pieces, or on anyone's) until ours are all done
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        Job job;
+        if (findJob(job)) {
+            runJob(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * Job system: runs independent pieces of work on a pool of worker threads.
+ *
+ * Each thread (the workers, and the thread that calls jobsInit(), usually
+ * the one holding the OpenGL context) has its own queue of jobs.  A thread
+ * takes work from the back of its own queue; one whose queue is empty
+ * steals from the front of another's, so the work spreads out without any
+ * central queue to contend for.  A thread waiting for its jobs to finish
+ * runs jobs meanwhile, rather than blocking.
+ *
+ * No job may make OpenGL calls: the context belongs to one thread.
+ */
+
+#ifndef __JOBS_H__
+#define __JOBS_H__
+
+// job type: process items begin (inclusive) to end (exclusive); 'data' is
+// whatever was given to parallelFor
+typedef void jobFunction(void* data, int begin, int end);
+
+// start 'workers' worker threads (a negative number: one fewer than the
+// machine has hardware threads); with none, parallelFor runs everything
+// on the calling thread
+void jobsInit(int workers = -1);
+
+// stop and join the worker threads
+void jobsShutdown(void);
+
+// the number of worker threads running
+int jobsWorkers(void);
+
+// call fcn(data, begin, end) over items 0 to count-1, in pieces of at most
+// 'grain' items, on as many threads as are free; returns once every piece
+// is done.  Pieces may run in any order and at the same time, so they must
+// not write anything in common.
+void parallelFor(int count, int grain, jobFunction* fcn, void* data);
+
+// the same, for a function object (e.g., a lambda) taking (begin, end)
+template <class Fcn>
+void parallelFor(int count, int grain, const Fcn& fcn) {
+    struct Call {
+        static void run(void* data, int begin, int end) {
+            (*(const Fcn*)data)(begin, end);
+        }
+    };
+    parallelFor(count, grain, Call::run, (void*)&fcn);
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Level of detail: one object generated at several tessellations, and the
+ * choice between them by how large the object appears on the screen.
+ */
+
+#include "lod.h"
+#include "cull.h"
+#include <cassert>
+
+// how far (as a fraction) past a threshold an object's size must go before
+// its level changes
+static const GLfloat HYSTERESIS = 0.15f;
+
+void LodSet::add(const ObjRef& ref, GLfloat minSize) {
+    assert(_count < MAX_LEVELS);
+    if (_count >= MAX_LEVELS) return;
+    _levels[_count] = ref;
+    _minSize[_count] = minSize;
+    _count++;
+}
+
+int LodSet::select(GLfloat size, int current) const {
+    if (_count == 0) return -1;
+
+    // nothing to be sticky about: take the first level the size allows
+    if (current < 0 || current >= _count) {
+        int i = 0;
+        while (i < _count - 1 && size < _minSize[i]) i++;
+        return i;
+    }
+
+    // move to a finer level only once clearly above its threshold, and to
+    // a coarser one only once clearly below the current level's
+    while (current > 0 && size >= _minSize[current - 1] * (1 + HYSTERESIS)) {
+        current--;
+    }
+    while (current < _count - 1 && size < _minSize[current] * (1 - HYSTERESIS)) {
+        current++;
+    }
+    return current;
+}
+
+GLfloat projectedSize(const vec4& sphere, const mat4& modelView,
+                      const mat4& projection, int viewportHeight) {
+    // the center and radius in eye coordinates; the radius grows by the
+    // model-view's largest scale factor
+    vec4 center = modelView * vec4(sphere.x, sphere.y, sphere.z, 1.0);
+    GLfloat radius = sphere.w * largestScale(modelView);
+
+    // at (or behind) the eye, it covers everything
+    GLfloat depth = -center.z;
+    if (depth <= radius) return 1e30f;
+
+    // projection[1][1] is the cotangent of half the vertical field of view
+    return 2 * radius / depth * projection[1][1] * viewportHeight / 2;
+}
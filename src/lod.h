@@ -0,0 +1,50 @@
+/*
+ * Level of detail: one object generated at several tessellations, and the
+ * choice between them by how large the object appears on the screen.
+ *
+ * Levels run from the finest (0) to the coarsest.  Level i is meant for
+ * when the object is at least minSize(i) pixels across; the coarsest
+ * level serves anything smaller.  Switching has some hysteresis, so an
+ * object whose size hovers around a threshold does not flip between
+ * levels every frame.
+ */
+
+#ifndef __LOD_H__
+#define __LOD_H__
+
+#include "mesh.h"
+#include "mat.h"
+
+class LodSet {
+public:
+    // the most levels a set can have
+    enum { MAX_LEVELS = 6 };
+
+private:
+    ObjRef _levels[MAX_LEVELS];
+    GLfloat _minSize[MAX_LEVELS]; // pixels across, at which each level begins
+    int _count;
+
+public:
+    // constructor: no levels
+    LodSet(): _count(0) { }
+
+    // add the next-coarser level, for objects at least minSize pixels across
+    void add(const ObjRef& ref, GLfloat minSize);
+
+    int count(void) const { return _count; }
+    const ObjRef& level(int i) const { return _levels[i]; }
+    GLfloat minSize(int i) const { return _minSize[i]; }
+
+    // the level for an object 'size' pixels across that is currently drawn
+    // at level 'current' (-1 if it has no level yet)
+    int select(GLfloat size, int current) const;
+};
+
+// how many pixels across a sphere (center and radius, in object
+// coordinates) appears, drawn with the given model-view and projection
+// matrices in a viewport 'viewportHeight' pixels high
+GLfloat projectedSize(const vec4& sphere, const mat4& modelView,
+                      const mat4& projection, int viewportHeight);
+
+#endif
@@ -3,7 +3,6 @@
  *
  */
 
-#include "cs432.h"
 #include "vec.h"
 #include "mat.h"
 
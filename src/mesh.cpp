@@ -0,0 +1,115 @@
+/*
+ * Mesh code; a container for generated vertices.
+ */
+
+#include "mesh.h"
+#include <cassert>
+#include <utility>
+
+// constructor: empty, owning its storage
+Mesh::Mesh(): _data(NULL), _count(0), _capacity(0), _external(false)
+{ }
+
+// constructor: writing into caller-owned storage
+Mesh::Mesh(Vertex* storage, int capacity)
+    : _data(storage), _count(0), _capacity(capacity), _external(true)
+{ }
+
+// copy constructor: exactly the other's vertices, in storage of our own
+Mesh::Mesh(const Mesh& other)
+    : _owned(other._data, other._data + other._count), _data(NULL),
+      _count(other._count), _capacity(other._count), _external(false)
+{
+    if (_count > 0) _data = &_owned[0];
+}
+
+// move constructor: moving the vector keeps its elements where they are,
+// so _data stays valid
+Mesh::Mesh(Mesh&& other)
+    : _owned(std::move(other._owned)), _data(other._data), _count(other._count),
+      _capacity(other._capacity), _external(other._external)
+{
+    other._owned.clear();
+    other._data = NULL;
+    other._count = other._capacity = 0;
+    other._external = false;
+}
+
+Mesh& Mesh::operator = (const Mesh& other) {
+    if (this != &other) *this = Mesh(other);
+    return *this;
+}
+
+Mesh& Mesh::operator = (Mesh&& other) {
+    if (this != &other) {
+        _owned = std::move(other._owned);
+        _data = other._data;
+        _count = other._count;
+        _capacity = other._capacity;
+        _external = other._external;
+        other._owned.clear();
+        other._data = NULL;
+        other._count = other._capacity = 0;
+        other._external = false;
+    }
+    return *this;
+}
+
+// exact, so a caller that knows its vertex count (see the generators'
+// ...VertexCount functions) allocates once, with nothing to spare
+void Mesh::reserve(int n) {
+    if (n > _capacity) setCapacity(n);
+}
+
+// make room for at least 'needed' vertices, doubling as we go
+void Mesh::grow(int needed) {
+    int newCapacity = _capacity > 0 ? _capacity * 2 : 64;
+    if (newCapacity < needed) newCapacity = needed;
+    setCapacity(newCapacity);
+}
+
+// move to storage of our own, for exactly n vertices.  Caller-owned
+// storage cannot grow; overflowing it is a sizing error, so we complain
+// (in debug builds) and carry on in storage of our own.
+void Mesh::setCapacity(int n) {
+    if (_external) {
+        assert(!"Mesh: caller-owned storage is too small");
+        _owned.assign(_data, _data + _count);
+        _external = false;
+    }
+    _owned.reserve(n);
+    _owned.resize(n);
+    _data = &_owned[0];
+    _capacity = n;
+}
+
+// the box is exact; the sphere is centered on the box, so it is not the
+// smallest possible, but it is close for our (mostly symmetric) objects
+Bounds Mesh::bounds(int start, int end) const {
+    Bounds b;
+    if (start >= end) {
+        b.min = b.max = b.center = vec3(0, 0, 0);
+        b.radius = 0;
+        return b;
+    }
+    b.min = b.max = vec3(_data[start].point.x, _data[start].point.y, _data[start].point.z);
+    for (int i = start + 1; i < end; i++) {
+        const vec4& p = _data[i].point;
+        if (p.x < b.min.x) b.min.x = p.x;
+        if (p.y < b.min.y) b.min.y = p.y;
+        if (p.z < b.min.z) b.min.z = p.z;
+        if (p.x > b.max.x) b.max.x = p.x;
+        if (p.y > b.max.y) b.max.y = p.y;
+        if (p.z > b.max.z) b.max.z = p.z;
+    }
+    b.center = (b.min + b.max) / 2;
+    GLfloat r2 = 0;
+    for (int i = start; i < end; i++) {
+        const vec4& p = _data[i].point;
+        vec3 d(p.x - b.center.x, p.y - b.center.y, p.z - b.center.z);
+        GLfloat d2 = dot(d, d);
+        if (d2 > r2) r2 = d2;
+    }
+    b.radius = sqrt(r2);
+    return b;
+}
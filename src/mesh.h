@@ -0,0 +1,132 @@
+/*
+ * Mesh code; the vertex format shared by all of our geometry generators,
+ * and a container for generated vertices.
+ *
+ * Nothing here depends on OpenGL, so geometry can be generated (and
+ * tested, or timed) without a context, and on any thread.
+ */
+
+#ifndef __MESH_H__
+#define __MESH_H__
+
+#include "vec.h"
+#include <vector>
+
+//----------------------------------------------------------------------------
+// one vertex, with all of the attributes our shaders use
+//----------------------------------------------------------------------------
+struct Vertex {
+    vec4 point;
+    vec3 normal;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 ambient;
+    GLfloat shininess;
+};
+
+//----------------------------------------------------------------------------
+// the space an object occupies, in its own coordinates: an axis-aligned
+// box, and a sphere around it
+//----------------------------------------------------------------------------
+struct Bounds {
+    vec3 min, max;
+    vec3 center;
+    GLfloat radius;
+};
+
+//----------------------------------------------------------------------------
+// class that defines a reference to an object on the GPU
+//----------------------------------------------------------------------------
+class ObjRef {
+	int startIdx;
+	int count;
+	Bounds bounds;
+public:
+	inline ObjRef(int start=0, int end=0):startIdx(start),count(end-start) { // constructor
+		bounds.radius = 0;
+	}
+	inline ObjRef(int start, int end, const Bounds& b):startIdx(start),count(end-start),bounds(b) { }
+	inline int getStartIdx() const { return startIdx; } // getter-function for start index
+	inline int getCount() const { return count; } // getter-function for count
+	inline const Bounds& getBounds() const { return bounds; } // getter-function for bounds
+};
+
+//----------------------------------------------------------------------------
+// a growable array of vertices.  By default the mesh owns its storage; it
+// can instead be given a span of caller-owned storage (an arena, or memory
+// mapped from a GPU buffer), in which case vertices are written there
+// directly.
+//----------------------------------------------------------------------------
+class Mesh {
+    std::vector<Vertex> _owned; // storage, when we own it
+    Vertex* _data;              // where vertices are written
+    int _count;                 // vertices written so far
+    int _capacity;              // room at _data
+    bool _external;             // whether _data is caller-owned
+
+    void grow(int needed);
+    void setCapacity(int n);
+
+public:
+    // constructor: an empty mesh that owns its storage
+    Mesh();
+
+    // constructor: a mesh that writes into 'capacity' vertices at 'storage'
+    Mesh(Vertex* storage, int capacity);
+
+    // a copy owns its vertices, whoever owns the original's; a move takes
+    // the original's storage (owned or not) and leaves it empty
+    Mesh(const Mesh& other);
+    Mesh(Mesh&& other);
+    Mesh& operator = (const Mesh& other);
+    Mesh& operator = (Mesh&& other);
+
+    // make room for exactly n vertices in all (if there is not already
+    // room for that many)
+    void reserve(int n);
+
+    // append a vertex
+    inline void add(const Vertex& v) {
+        if (_count == _capacity) grow(_count + 1);
+        _data[_count++] = v;
+    }
+
+    // append a vertex whose three colors are the same
+    inline void add(const vec4& point, const vec3& normal, const vec4& color,
+                    GLfloat shininess) {
+        if (_count == _capacity) grow(_count + 1);
+        Vertex& v = _data[_count++];
+        v.point = point;
+        v.normal = normal;
+        v.diffuse = color;
+        v.specular = color;
+        v.ambient = color;
+        v.shininess = shininess;
+    }
+
+    // forget all vertices (keeping the storage)
+    void clear() { _count = 0; }
+
+    int size() const { return _count; }
+    int capacity() const { return _capacity; }
+
+    // true while writing into caller-owned storage; becomes false if the
+    // caller's storage overflowed and the vertices had to be moved
+    bool external() const { return _external; }
+
+    Vertex* data() { return _data; }
+    const Vertex* data() const { return _data; }
+    Vertex& operator [] (int i) { return _data[i]; }
+    const Vertex& operator [] (int i) const { return _data[i]; }
+
+    // the bounds of the vertices from 'start' up to 'end'
+    Bounds bounds(int start, int end) const;
+
+    // a reference to the object made of the vertices from 'start' on, with
+    // its bounds; generators return this once they are done
+    ObjRef objectFrom(int start) const {
+        return ObjRef(start, _count, bounds(start, _count));
+    }
+};
+
+#endif
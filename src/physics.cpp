@@ -0,0 +1,406 @@
+/*
+ * Rigid-body physics for dice: cubes that fall, bounce, tumble and come to
+ * rest on a ground plane and against one another.
+ */
+
+#include "physics.h"
+#include "profiler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define PHYSICS_SSE 1
+#endif
+
+// how bouncy and how grippy the dice are
+static const GLfloat RESTITUTION = 0.35f;
+static const GLfloat FRICTION = 0.5f;
+
+// impacts slower than this (units per second) do not bounce, so resting
+// dice do not jitter
+static const GLfloat BOUNCE_THRESHOLD = 2.0f;
+
+// the solver's passes per step, and how it removes overlap: this fraction
+// of the overlap beyond SLOP, per step
+static const int ITERATIONS = 10;
+static const GLfloat BAUMGARTE = 0.2f;
+static const GLfloat SLOP = 0.005f;
+
+// a little air resistance (per second), so that spinning dies down
+static const GLfloat LINEAR_DAMPING = 0.1f;
+static const GLfloat ANGULAR_DAMPING = 0.3f;
+
+// a body slower than these (units, and radians, per second) for
+// SLEEP_TIME seconds falls asleep
+static const GLfloat SLEEP_LINEAR = 0.3f;
+static const GLfloat SLEEP_ANGULAR = 0.5f;
+static const GLfloat SLEEP_TIME = 0.4f;
+
+static const GLfloat RadiansToDegrees = GLfloat(180 / M_PI);
+
+// a body the solver may move
+static bool moves(const RigidBox& b) {
+    return !b.asleep && b.invMass > 0;
+}
+
+// the three half-edges of a box, in world coordinates
+static void halfAxes(const RigidBox& b, vec3* axes) {
+    axes[0] = rotate(b.orientation, vec3(b.halfSize, 0, 0));
+    axes[1] = rotate(b.orientation, vec3(0, b.halfSize, 0));
+    axes[2] = rotate(b.orientation, vec3(0, 0, b.halfSize));
+}
+
+// the eight corners of a box
+static void corners(const RigidBox& b, vec3* out) {
+    vec3 axes[3];
+    halfAxes(b, axes);
+    for (int i = 0; i < 8; i++) {
+        out[i] = b.position + (i & 1 ? axes[0] : -axes[0]) +
+                 (i & 2 ? axes[1] : -axes[1]) + (i & 4 ? axes[2] : -axes[2]);
+    }
+}
+
+//----------------------------------------------------------------------------
+
+PhysicsWorld::PhysicsWorld(GLfloat groundY, const vec3& gravity)
+    : _groundY(groundY), _gravity(gravity)
+{
+    PhysicsStats none = { 0, 0, 0, 0 };
+    _stats = none;
+}
+
+int PhysicsWorld::addBox(const vec3& position, const quat& orientation,
+                         GLfloat halfSize, GLfloat mass, bool asleep) {
+    RigidBox b;
+    b.position = position;
+    b.orientation = orientation;
+    b.velocity = vec3(0, 0, 0);
+    b.angularVelocity = vec3(0, 0, 0);
+    b.halfSize = halfSize;
+    b.invMass = mass > 0 ? 1 / mass : 0;
+    // a solid cube of side s: I = m s^2 / 6
+    GLfloat side = 2 * halfSize;
+    b.invInertia = mass > 0 ? 6 / (mass * side * side) : 0;
+    b.asleep = asleep;
+    b.stillTime = 0;
+    _bodies.push_back(b);
+    _order.push_back((int)_bodies.size() - 1);
+    return (int)_bodies.size() - 1;
+}
+
+void PhysicsWorld::wake(int i) {
+    _bodies[i].asleep = false;
+    _bodies[i].stillTime = 0;
+}
+
+bool PhysicsWorld::allAsleep(void) const {
+    for (size_t i = 0; i < _bodies.size(); i++) {
+        if (!_bodies[i].asleep) return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  Broadphase: sweep and prune along x
+//----------------------------------------------------------------------------
+
+// each body's bounding box, then the bodies sorted by the boxes' lowest x
+void PhysicsWorld::updateBounds(void) {
+    int n = count();
+    _lo.resize(n);
+    _hi.resize(n);
+    for (int i = 0; i < n; i++) {
+        const RigidBox& b = _bodies[i];
+        vec3 axes[3];
+        halfAxes(b, axes);
+        vec3 extent(fabs(axes[0].x) + fabs(axes[1].x) + fabs(axes[2].x),
+                    fabs(axes[0].y) + fabs(axes[1].y) + fabs(axes[2].y),
+                    fabs(axes[0].z) + fabs(axes[1].z) + fabs(axes[2].z));
+        _lo[i] = b.position - extent;
+        _hi[i] = b.position + extent;
+    }
+
+    // insertion sort: bodies move little between steps, so this is close
+    // to linear; it is also stable, which keeps the pair order repeatable
+    for (int i = 1; i < n; i++) {
+        int body = _order[i];
+        GLfloat key = _lo[body].x;
+        int j = i - 1;
+        while (j >= 0 && _lo[_order[j]].x > key) {
+            _order[j + 1] = _order[j];
+            j--;
+        }
+        _order[j + 1] = body;
+    }
+
+    _minX.resize(n); _maxX.resize(n);
+    _minY.resize(n); _maxY.resize(n);
+    _minZ.resize(n); _maxZ.resize(n);
+    for (int i = 0; i < n; i++) {
+        int body = _order[i];
+        _minX[i] = _lo[body].x; _maxX[i] = _hi[body].x;
+        _minY[i] = _lo[body].y; _maxY[i] = _hi[body].y;
+        _minZ[i] = _lo[body].z; _maxZ[i] = _hi[body].z;
+    }
+}
+
+// the pairs of bodies whose boxes overlap, at least one of them awake.
+// In sorted order, the boxes overlapping box i along x are the ones just
+// after it, up to the first that starts past its end; those are tested in
+// y and z four at a time.
+void PhysicsWorld::findPairs(void) {
+    _pairs.clear();
+    int n = count();
+    for (int i = 0; i < n; i++) {
+        int end = i + 1;
+        while (end < n && _minX[end] <= _maxX[i]) end++;
+        _stats.candidates += end - (i + 1);
+
+        int j = i + 1;
+#ifdef PHYSICS_SSE
+        __m128 loY = _mm_set1_ps(_minY[i]), hiY = _mm_set1_ps(_maxY[i]);
+        __m128 loZ = _mm_set1_ps(_minZ[i]), hiZ = _mm_set1_ps(_maxZ[i]);
+        for (; j + 4 <= end; j += 4) {
+            __m128 overlap = _mm_and_ps(
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&_minY[j]), hiY),
+                           _mm_cmpge_ps(_mm_loadu_ps(&_maxY[j]), loY)),
+                _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&_minZ[j]), hiZ),
+                           _mm_cmpge_ps(_mm_loadu_ps(&_maxZ[j]), loZ)));
+            int mask = _mm_movemask_ps(overlap);
+            for (int k = 0; k < 4; k++) {
+                if (!(mask & (1 << k))) continue;
+                _pairs.push_back(_order[i]);
+                _pairs.push_back(_order[j + k]);
+            }
+        }
+#endif
+        for (; j < end; j++) {
+            if (_minY[j] <= _maxY[i] && _maxY[j] >= _minY[i] &&
+                _minZ[j] <= _maxZ[i] && _maxZ[j] >= _minZ[i]) {
+                _pairs.push_back(_order[i]);
+                _pairs.push_back(_order[j]);
+            }
+        }
+    }
+
+    // sleepers resting side by side need nothing done
+    size_t kept = 0;
+    for (size_t p = 0; p < _pairs.size(); p += 2) {
+        if (_bodies[_pairs[p]].asleep && _bodies[_pairs[p + 1]].asleep) continue;
+        _pairs[kept++] = _pairs[p];
+        _pairs[kept++] = _pairs[p + 1];
+    }
+    _pairs.resize(kept);
+    _stats.pairs = (int)kept / 2;
+}
+
+//----------------------------------------------------------------------------
+//  Contacts
+//----------------------------------------------------------------------------
+
+void PhysicsWorld::addContact(int a, int b, const vec3& point, const vec3& normal,
+                              GLfloat depth) {
+    Contact c;
+    c.a = a;
+    c.b = b;
+    c.point = point;
+    c.normal = normal;
+    c.depth = depth;
+    c.normalImpulse = 0;
+    c.tangentImpulse[0] = c.tangentImpulse[1] = 0;
+
+    // two directions along the contact surface, for friction
+    vec3 other = fabs(normal.x) < 0.9f ? vec3(1, 0, 0) : vec3(0, 1, 0);
+    c.tangent[0] = normalize(cross(normal, other));
+    c.tangent[1] = cross(normal, c.tangent[0]);
+
+    // bounce back at a fraction of the closing speed, unless it is slow
+    GLfloat closing = dot(relativeVelocity(c), normal);
+    c.bounce = closing < -BOUNCE_THRESHOLD ? -RESTITUTION * closing : 0;
+    _contacts.push_back(c);
+}
+
+// the corners of body i at or below the ground
+void PhysicsWorld::groundContacts(int i) {
+    vec3 points[8];
+    corners(_bodies[i], points);
+    for (int k = 0; k < 8; k++) {
+        GLfloat depth = _groundY - points[k].y;
+        if (depth >= 0) addContact(i, -1, points[k], vec3(0, 1, 0), depth);
+    }
+}
+
+// a sleeping body is woken when a moving one touches it
+void PhysicsWorld::wakeTouching(int a, int b) {
+    RigidBox& ba = _bodies[a];
+    RigidBox& bb = _bodies[b];
+    if (ba.asleep && !bb.asleep && bb.stillTime == 0) wake(a);
+    if (bb.asleep && !ba.asleep && ba.stillTime == 0) wake(b);
+}
+
+// the corners of each box that are inside the other.  A corner of a inside
+// b is pushed out through b's nearest face, and the other way about.
+void PhysicsWorld::boxContacts(int a, int b) {
+    size_t before = _contacts.size();
+    for (int pass = 0; pass < 2; pass++) {
+        int inner = pass == 0 ? a : b;   // whose corners
+        int outer = pass == 0 ? b : a;   // whose box
+        const RigidBox& box = _bodies[outer];
+        quat toBox = conjugate(box.orientation);
+        vec3 points[8];
+        corners(_bodies[inner], points);
+        for (int k = 0; k < 8; k++) {
+            vec3 local = rotate(toBox, points[k] - box.position);
+            GLfloat depth = box.halfSize;
+            int axis = -1;
+            for (int d = 0; d < 3; d++) {
+                GLfloat inside = box.halfSize - fabs(local[d]);
+                if (inside < 0) { axis = -1; break; }
+                if (inside <= depth) { depth = inside; axis = d; }
+            }
+            if (axis < 0) continue;
+            vec3 out(0, 0, 0);
+            out[axis] = local[axis] < 0 ? -1.0f : 1.0f;
+            vec3 normal = rotate(box.orientation, out);
+            // the contact pushes a along its normal
+            addContact(a, b, points[k], pass == 0 ? normal : -normal, depth);
+        }
+    }
+    if (_contacts.size() > before) wakeTouching(a, b);
+}
+
+//----------------------------------------------------------------------------
+//  Solver
+//----------------------------------------------------------------------------
+
+vec3 PhysicsWorld::relativeVelocity(const Contact& c) const {
+    const RigidBox& a = _bodies[c.a];
+    vec3 v = a.velocity + cross(a.angularVelocity, c.point - a.position);
+    if (c.b >= 0) {
+        const RigidBox& b = _bodies[c.b];
+        v -= b.velocity + cross(b.angularVelocity, c.point - b.position);
+    }
+    return v;
+}
+
+// apply 'impulse' to a at the contact point, and its opposite to b
+void PhysicsWorld::applyImpulse(const Contact& c, const vec3& impulse) {
+    RigidBox& a = _bodies[c.a];
+    if (moves(a)) {
+        a.velocity += impulse * a.invMass;
+        a.angularVelocity += cross(c.point - a.position, impulse) * a.invInertia;
+    }
+    if (c.b >= 0) {
+        RigidBox& b = _bodies[c.b];
+        if (moves(b)) {
+            b.velocity -= impulse * b.invMass;
+            b.angularVelocity -= cross(c.point - b.position, impulse) * b.invInertia;
+        }
+    }
+}
+
+// the inverse of the mass a contact's bodies present along 'direction'
+static GLfloat inverseMassAlong(const RigidBox& a, const RigidBox* b,
+                                const vec3& point, const vec3& direction) {
+    GLfloat k = 0;
+    if (moves(a)) {
+        vec3 r = cross(point - a.position, direction);
+        k += a.invMass + a.invInertia * dot(r, r);
+    }
+    if (b != NULL && moves(*b)) {
+        vec3 r = cross(point - b->position, direction);
+        k += b->invMass + b->invInertia * dot(r, r);
+    }
+    return k;
+}
+
+// sequential impulses: each pass fixes each contact's velocity in turn,
+// keeping each contact's total impulse pushing (never pulling) and its
+// friction within the friction cone
+void PhysicsWorld::solve(GLfloat dt) {
+    for (int pass = 0; pass < ITERATIONS; pass++) {
+        for (size_t i = 0; i < _contacts.size(); i++) {
+            Contact& c = _contacts[i];
+            const RigidBox& a = _bodies[c.a];
+            const RigidBox* b = c.b >= 0 ? &_bodies[c.b] : NULL;
+
+            GLfloat kn = inverseMassAlong(a, b, c.point, c.normal);
+            if (kn <= 0) continue;
+            GLfloat vn = dot(relativeVelocity(c), c.normal);
+            GLfloat push = BAUMGARTE / dt * (c.depth > SLOP ? c.depth - SLOP : 0);
+            GLfloat target = c.bounce > push ? c.bounce : push;
+            GLfloat total = c.normalImpulse + (target - vn) / kn;
+            if (total < 0) total = 0;
+            GLfloat delta = total - c.normalImpulse;
+            c.normalImpulse = total;
+            applyImpulse(c, c.normal * delta);
+
+            GLfloat limit = FRICTION * c.normalImpulse;
+            for (int t = 0; t < 2; t++) {
+                GLfloat kt = inverseMassAlong(a, b, c.point, c.tangent[t]);
+                if (kt <= 0) continue;
+                GLfloat vt = dot(relativeVelocity(c), c.tangent[t]);
+                GLfloat sum = c.tangentImpulse[t] - vt / kt;
+                if (sum > limit) sum = limit;
+                if (sum < -limit) sum = -limit;
+                GLfloat change = sum - c.tangentImpulse[t];
+                c.tangentImpulse[t] = sum;
+                applyImpulse(c, c.tangent[t] * change);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+
+void PhysicsWorld::step(GLfloat dt) {
+    if (dt <= 0) return;
+    PROFILE_ZONE("physics");
+    PhysicsStats none = { 0, 0, 0, 0 };
+    _stats = none;
+    int n = count();
+
+    // gravity and air resistance
+    for (int i = 0; i < n; i++) {
+        RigidBox& b = _bodies[i];
+        if (!moves(b)) continue;
+        b.velocity += _gravity * dt;
+        b.velocity *= 1 / (1 + LINEAR_DAMPING * dt);
+        b.angularVelocity *= 1 / (1 + ANGULAR_DAMPING * dt);
+    }
+
+    // what touches what
+    _contacts.clear();
+    updateBounds();
+    findPairs();
+    for (size_t p = 0; p < _pairs.size(); p += 2) {
+        boxContacts(_pairs[p], _pairs[p + 1]);
+    }
+    for (int i = 0; i < n; i++) {
+        if (moves(_bodies[i])) groundContacts(i);
+    }
+    _stats.contacts = (int)_contacts.size();
+
+    solve(dt);
+
+    // move, and let whatever has been still long enough sleep
+    for (int i = 0; i < n; i++) {
+        RigidBox& b = _bodies[i];
+        if (!moves(b)) continue;
+        _stats.awake++;
+        b.position += b.velocity * dt;
+        b.orientation = integrate(b.orientation, b.angularVelocity * RadiansToDegrees, dt);
+
+        if (dot(b.velocity, b.velocity) < SLEEP_LINEAR * SLEEP_LINEAR &&
+            dot(b.angularVelocity, b.angularVelocity) < SLEEP_ANGULAR * SLEEP_ANGULAR) {
+            b.stillTime += dt;
+        }
+        else {
+            b.stillTime = 0;
+        }
+        if (b.stillTime >= SLEEP_TIME) {
+            b.asleep = true;
+            b.velocity = vec3(0, 0, 0);
+            b.angularVelocity = vec3(0, 0, 0);
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * Rigid-body physics for dice: cubes that fall, bounce, tumble and come to
+ * rest on a ground plane and against one another.
+ *
+ * Each step advances the world by a fixed time:
+ *   - gravity changes the velocities of the bodies that are awake;
+ *   - a sweep-and-prune broadphase finds the pairs of bodies whose
+ *     bounding boxes overlap, and contacts are found between those pairs
+ *     (box against box) and between each body and the ground;
+ *   - a sequential-impulse solver pushes the bodies apart, with
+ *     restitution and friction, over a few iterations;
+ *   - positions and orientations move by the new velocities;
+ *   - a body that has been nearly still for a while falls asleep: it is
+ *     neither moved nor tested against other sleepers until something
+ *     touches it.
+ *
+ * Nothing here is random and everything happens in a fixed order, so the
+ * same world stepped with the same time steps always ends up the same.
+ *
+ * Box-against-box contacts are found at corners of one box inside the
+ * other.  That misses edge-against-edge crossings, which dice (resting or
+ * tumbling into each other) rarely need.
+ */
+
+#ifndef __PHYSICS_H__
+#define __PHYSICS_H__
+
+#include "vec.h"
+#include "quat.h"
+#include <vector>
+
+// one cube
+struct RigidBox {
+    vec3 position;
+    quat orientation;
+    vec3 velocity;         // units per second
+    vec3 angularVelocity;  // radians per second, about the world's axes
+    GLfloat halfSize;      // half the length of a side
+    GLfloat invMass;       // 0 for an immovable body
+    GLfloat invInertia;    // a cube's inertia is the same about any axis
+    bool asleep;
+    GLfloat stillTime;     // how long it has been nearly still, in seconds
+};
+
+// what the last step did
+struct PhysicsStats {
+    int awake;       // bodies awake during the step
+    int candidates;  // pairs whose bounds overlap along x (from the sweep)
+    int pairs;       // pairs whose bounds overlap (tested for contacts)
+    int contacts;    // contact points solved
+};
+
+class PhysicsWorld {
+    // a contact point: body a is pushed along 'normal', body b (or, when
+    // b is -1, the ground) the other way
+    struct Contact {
+        int a, b;
+        vec3 point;
+        vec3 normal;
+        vec3 tangent[2];
+        GLfloat depth;
+        GLfloat bounce;         // the separating speed restitution asks for
+        GLfloat normalImpulse;  // impulses applied so far this step
+        GLfloat tangentImpulse[2];
+    };
+
+    std::vector<RigidBox> _bodies;
+    GLfloat _groundY;
+    vec3 _gravity;
+
+    // the broadphase: each body's bounding box; the bodies in order of
+    // their boxes' lowest x, kept from step to step (so it is nearly sorted
+    // already); and the boxes in that order, one array per coordinate
+    std::vector<vec3> _lo, _hi;
+    std::vector<int> _order;
+    std::vector<GLfloat> _minX, _maxX, _minY, _maxY, _minZ, _maxZ;
+    std::vector<int> _pairs; // overlapping pairs, two indices each
+
+    std::vector<Contact> _contacts;
+    PhysicsStats _stats;
+
+    void updateBounds(void);
+    void findPairs(void);
+    void addContact(int a, int b, const vec3& point, const vec3& normal, GLfloat depth);
+    void groundContacts(int i);
+    void boxContacts(int a, int b);
+    void solve(GLfloat dt);
+    void applyImpulse(const Contact& c, const vec3& impulse);
+    vec3 relativeVelocity(const Contact& c) const;
+    void wakeTouching(int a, int b);
+
+public:
+    // constructor: an empty world with the ground at height groundY
+    PhysicsWorld(GLfloat groundY = 0, const vec3& gravity = vec3(0, -60, 0));
+
+    // add a cube; returns its index.  It starts asleep, unless told
+    // otherwise, so that bodies set down at rest stay exactly where they
+    // were put.
+    int addBox(const vec3& position, const quat& orientation, GLfloat halfSize,
+               GLfloat mass = 1, bool asleep = true);
+
+    int count(void) const { return (int)_bodies.size(); }
+    RigidBox& body(int i) { return _bodies[i]; }
+    const RigidBox& body(int i) const { return _bodies[i]; }
+
+    // wake a body (e.g., before setting it moving)
+    void wake(int i);
+
+    // whether every body is asleep
+    bool allAsleep(void) const;
+
+    // advance the world by dt seconds
+    void step(GLfloat dt);
+
+    const PhysicsStats& stats(void) const { return _stats; }
+};
+
+#endif
@@ -10,6 +10,9 @@
 #include <iostream>
 #include "cs432.h"
 #include "picking.h"
+#include "glState.h"
+#include "profiler.h"
+#include "frameClock.h"
 #include "vec.h"
 
 using namespace std;
@@ -19,31 +22,34 @@ static int gpuPickColorId;
 static int xVal;
 static int yVal;
 static GLfloat savedClearColor[4];
+static double pickStart = 0;
+static double lastLatency = -1;
 
 static bool doShowPickColors = false;
 
 void showPickColors(bool b) {
 	doShowPickColors = b;
-	if (b) glClearColor(0,0,0,1);
+	if (b) stateClearColor(0,0,0,1);
 }
 
 void setGpuPickColorId(int n) {
 	gpuPickColorId = n;
-	glUniform4fv(gpuPickColorId, 1, vec4(0,0,0,-1));
+	stateUniform4fv(gpuPickColorId, vec4(0,0,0,-1));
 	if (doShowPickColors) {
-		glClearColor(0,0,0,1); //  background
+		stateClearColor(0,0,0,1); //  background
 	}
 }
 void startPicking(pickCallbackFunction* fcn, int x, int y) {
 	if (fcn != NULL && callback == NULL) {
 		callback = fcn;		
 		
-		glGetFloatv(GL_COLOR_CLEAR_VALUE, savedClearColor);
-		glClearColor(0.0,0.0,0.0,1.0); //  background
+		stateGetClearColor(savedClearColor);
+		stateClearColor(0.0,0.0,0.0,1.0); //  background
 		GLint viewportInfo[4];
-		glGetIntegerv(GL_VIEWPORT, viewportInfo);
+		stateGetViewport(viewportInfo);
 		yVal = viewportInfo[3]-y; // invert y with respect to pixel coordinates
 		xVal = x;
+		pickStart = clockNow();
 		
 		glutPostRedisplay();
 	}
@@ -51,22 +57,25 @@ void startPicking(pickCallbackFunction* fcn, int x, int y) {
 
 void endPicking(void) {
 	if (callback == NULL) return;
+	PROFILE_ZONE("pick readback");
 	pickCallbackFunction* tempFcn = callback;
 	callback = NULL;
-	glDisableVertexAttribArray(0);
 	glFlush();
 	glFinish();
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	statePixelStorei(GL_PACK_ALIGNMENT, 1); // reading packs the pixel
 	unsigned int data;
 	glReadPixels(xVal,yVal,1,1, GL_RGBA, GL_UNSIGNED_BYTE, &data);
 	data &= 0xffffff;
-	glEnableVertexAttribArray(0);
-	glUniform4fv(gpuPickColorId, 1, vec4(0,0,0,-1));
+	stateUniform4fv(gpuPickColorId, vec4(0,0,0,-1));
 	if (!doShowPickColors) {
-		glClearColor(savedClearColor[0],savedClearColor[1],savedClearColor[2],savedClearColor[3]); //  background
+		stateClearColor(savedClearColor[0],savedClearColor[1],savedClearColor[2],savedClearColor[3]); //  background
 	}
+	lastLatency = clockNow() - pickStart;
 	tempFcn(data);
 }
+double pickLatency(void) {
+	return lastLatency;
+}
 bool inPickingMode(void) {
 	return callback != NULL;
 }
@@ -74,15 +83,25 @@ bool inPickingMode(void) {
 void clearPickId(void) {
 	if (callback == NULL) return;
 	// black, so the object acts as background
-	glUniform4fv(gpuPickColorId, 1, vec4(0,0,0,1));
+	stateUniform4fv(gpuPickColorId, vec4(0,0,0,1));
 }
 
-void setPickId(int n) {
-	if (!doShowPickColors && callback == NULL) return;
+// the color that encodes a pick-id
+static vec4 pickColor(int n) {
 	int blue = (n / 256 / 256) & 0xff;
 	int green = (n / 256) & 0xff;
 	int red = n & 0xff;
-	vec4 thisColor(red/255.0 + 0.0001, green/255.0 + 0.0001, blue/255.0 + 0.0001, 1.0);
-	glUniform4fv(gpuPickColorId, 1, thisColor);
+	return vec4(red/255.0 + 0.0001, green/255.0 + 0.0001, blue/255.0 + 0.0001, 1.0);
+}
+
+void setPickId(int n) {
+	if (!doShowPickColors && callback == NULL) return;
+	stateUniform4fv(gpuPickColorId, pickColor(n));
+}
+
+vec4 pickColorFor(int n) {
+	if (!doShowPickColors && callback == NULL) return vec4(0,0,0,-1);
+	if (n == 0) return vec4(0,0,0,1); // black, so the object acts as background
+	return pickColor(n);
 }
 
@@ -9,6 +9,8 @@
 #ifndef __PICKING_H__
 #define __PICKING_H__
 
+#include "vec.h"
+
 typedef void pickCallbackFunction(int code);
 
 void showPickColors(bool b);
@@ -21,8 +23,17 @@ void endPicking(void);
 
 bool inPickingMode(void);
 
+// the seconds the last pick took, from the click to the callback (which
+// waits for a frame to be drawn and read back); negative before the first
+double pickLatency(void);
+
 void clearPickId(void) ;
 
 void setPickId(int n);
 
+// the pick color an object with the given pick-id should be drawn in
+// right now, for objects that carry their own (e.g., instanced ones);
+// alpha is negative when not picking, meaning "draw normally"
+vec4 pickColorFor(int n);
+
 #endif
@@ -0,0 +1,361 @@
+/*
+ * The computer player for Pig: plays to maximize its chance of winning.
+ */
+
+#include "cs432.h"
+#include "pigAI.h"
+#include "jobs.h"
+#include "frameClock.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// how close a chance must come to consistent before it counts as solved,
+// and the most secant steps to take getting there
+static const double TOLERANCE = 1e-13;
+static const int MAX_STEPS = 100;
+
+// the pairs of columns one job works out
+static const int PAIR_GRAIN = 2;
+
+// what a player does without a table: the usual rule of thumb
+static const int FALLBACK_HOLD_AT = 20;
+
+// the cache file: this header, the roll bits (padded to a multiple of four
+// bytes), then the chances of winning
+struct TableHeader {
+    char magic[4];       // "PIG1"
+    uint32_t byteOrder;  // BYTE_ORDER_MARK, as written by this machine
+    uint32_t target;
+    uint32_t bitBytes;   // bytes of roll bits, with padding
+};
+static const char MAGIC[4] = { 'P', 'I', 'G', '1' };
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// the table in use, either in the vectors or in the mapped file
+static int tableTarget = 0;
+static const unsigned char* rollBits = NULL;
+static const float* winChance = NULL;
+static std::vector<unsigned char> solvedBits;
+static std::vector<float> solvedChance;
+#ifdef _WIN32
+static HANDLE mappedFile = INVALID_HANDLE_VALUE, mapping = NULL;
+#endif
+static void* mapped = NULL;
+static size_t mappedSize = 0;
+
+static size_t bitBytes(int target) {
+    size_t bits = (size_t)target * target * target;
+    return ((bits + 7) / 8 + 3) & ~(size_t)3;
+}
+
+static size_t fileSize(int target) {
+    return sizeof(TableHeader) + bitBytes(target) + (size_t)target * target * sizeof(float);
+}
+
+//----------------------------------------------------------------------------
+//  Solving
+//----------------------------------------------------------------------------
+
+// work out the column of turn totals for i points against j, given the
+// chance the opponent would win from the start of their turn (j against
+// i); returns the chance at the start of this turn
+static double solveColumn(double* p, int n, int i, int j, double opponentWins) {
+    double* column = &p[((size_t)i * n + j) * n];
+    double handOver = 1 - opponentWins;
+    for (int k = n - 1 - i; k >= 0; k--) {
+        double roll = handOver; // rolled a 1
+        for (int r = 2; r <= 6; r++) {
+            roll += i + k + r >= n ? 1 : column[k + r];
+        }
+        roll /= 6;
+        double hold = k == 0 ? handOver : 1 - p[((size_t)j * n + i + k) * n];
+        column[k] = roll > hold ? roll : hold;
+    }
+    return column[0];
+}
+
+// solve i against j and j against i together, given every state with a
+// higher sum of banked scores: find x = P(i, j, 0) with x = F(x), where F
+// runs through P(j, i, 0) and back.  F is piecewise linear with a slope
+// below one, so secant steps land on the answer in a handful of tries
+// where plain iteration would creep toward it.
+static void solvePair(double* p, int n, int i, int j, double guess) {
+    // how far F(x) is from x
+    auto residual = [&](double x) {
+        double y = solveColumn(p, n, j, i, x);
+        return solveColumn(p, n, i, j, y) - x;
+    };
+    double x0 = guess, r0 = residual(x0);
+    if (fabs(r0) < TOLERANCE) return;
+    double x1 = x0 + r0, r1 = residual(x1);
+    for (int step = 0; fabs(r1) >= TOLERANCE && step < MAX_STEPS; step++) {
+        double x2 = r1 != r0 ? x1 - r1 * (x1 - x0) / (r1 - r0) : x1 + r1;
+        if (x2 < 0) x2 = 0;
+        if (x2 > 1) x2 = 1;
+        x0 = x1;
+        r0 = r1;
+        x1 = x2;
+        r1 = residual(x1);
+    }
+}
+
+double pigSolve(int target, unsigned char* bits, float* chance) {
+    double start = clockNow();
+    const int n = target;
+
+    // P(i, j, k) at (i * n + j) * n + k; only k < n - i is used
+    std::vector<double> p((size_t)n * n * n, 0.0);
+
+    // layers of equal i + j, highest first; the pairs in a layer (i <= j)
+    // have nothing to do with one another
+    for (int s = 2 * n - 2; s >= 0; s--) {
+        int iLo = s - (n - 1) > 0 ? s - (n - 1) : 0;
+        int pairs = s / 2 - iLo + 1;
+        parallelFor(pairs, PAIR_GRAIN, [&](int begin, int end) {
+            for (int c = begin; c < end; c++) {
+                int i = iLo + c, j = s - i;
+                // a first guess: the chance with the opponent a point
+                // further on (from the layer above), which is close
+                double guess = j + 1 < n ? p[((size_t)i * n + j + 1) * n] : 0.5;
+                solvePair(&p[0], n, i, j, guess);
+            }
+        });
+    }
+
+    // the decisions, from the solved chances
+    memset(bits, 0, ((size_t)n * n * n + 7) / 8);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            const double* column = &p[((size_t)i * n + j) * n];
+            double handOver = 1 - p[((size_t)j * n + i) * n];
+            for (int k = 0; k < n - i; k++) {
+                double roll = handOver;
+                for (int r = 2; r <= 6; r++) {
+                    roll += i + k + r >= n ? 1 : column[k + r];
+                }
+                roll /= 6;
+                double hold = k == 0 ? handOver : 1 - p[((size_t)j * n + i + k) * n];
+                if (roll > hold) {
+                    size_t bit = ((size_t)i * n + j) * n + k;
+                    bits[bit >> 3] |= (unsigned char)(1 << (bit & 7));
+                }
+            }
+            chance[i * n + j] = (float)column[0];
+        }
+    }
+    return clockNow() - start;
+}
+
+//----------------------------------------------------------------------------
+//  The cache file
+//----------------------------------------------------------------------------
+
+static void unmapTable(void) {
+#ifdef _WIN32
+    if (mapped != NULL) UnmapViewOfFile(mapped);
+    if (mapping != NULL) CloseHandle(mapping);
+    if (mappedFile != INVALID_HANDLE_VALUE) CloseHandle(mappedFile);
+    mapping = NULL;
+    mappedFile = INVALID_HANDLE_VALUE;
+#else
+    if (mapped != NULL) munmap(mapped, mappedSize);
+#endif
+    mapped = NULL;
+    mappedSize = 0;
+}
+
+// map the whole of a file read-only; false if it is not 'size' bytes long
+static bool mapTable(const char* filename, size_t size) {
+#ifdef _WIN32
+    mappedFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (mappedFile == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(mappedFile, &length) || (size_t)length.QuadPart != size) {
+        unmapTable();
+        return false;
+    }
+    mapping = CreateFileMappingA(mappedFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL) mapped = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (mapped == NULL) {
+        unmapTable();
+        return false;
+    }
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size != size) {
+        close(fd);
+        return false;
+    }
+    void* address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file open
+    if (address == MAP_FAILED) return false;
+    mapped = address;
+#endif
+    mappedSize = size;
+    return true;
+}
+
+// use the table in 'filename', if it is one for this target
+static bool loadTable(int target, const char* filename) {
+    if (!mapTable(filename, fileSize(target))) return false;
+    const TableHeader* header = (const TableHeader*)mapped;
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || header->byteOrder != BYTE_ORDER_MARK || (int)header->target != target
+        || header->bitBytes != bitBytes(target)) {
+        unmapTable();
+        return false;
+    }
+    rollBits = (const unsigned char*)(header + 1);
+    winChance = (const float*)(rollBits + header->bitBytes);
+    tableTarget = target;
+    return true;
+}
+
+// write the table to a file of this process's own beside 'filename', then
+// move it into place: another process may have the old file mapped, or be
+// about to map it, and must only ever see a whole table
+static bool writeTable(int target, const char* filename) {
+#ifdef _WIN32
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = (unsigned long)getpid();
+#endif
+    std::string temp = std::string(filename) + "." + std::to_string(pid);
+    FILE* fp = NULL;
+    fopen_s(&fp, temp.c_str(), "wb");
+    if (fp == NULL) return false;
+    TableHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.target = (uint32_t)target;
+    header.bitBytes = (uint32_t)bitBytes(target);
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+        && fwrite(&solvedBits[0], 1, solvedBits.size(), fp) == solvedBits.size()
+        && fwrite(&solvedChance[0], sizeof(float), solvedChance.size(), fp)
+           == solvedChance.size();
+    ok = fclose(fp) == 0 && ok;
+#ifdef _WIN32
+    ok = ok && MoveFileExA(temp.c_str(), filename, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = ok && rename(temp.c_str(), filename) == 0;
+#endif
+    if (!ok) remove(temp.c_str());
+    return ok;
+}
+
+//----------------------------------------------------------------------------
+
+bool pigInit(int target, const char* cacheFile) {
+    pigShutdown();
+    if (target <= 0) return false;
+    if (cacheFile != NULL && loadTable(target, cacheFile)) {
+        std::cout << "pig: " << target << "-point table mapped from "
+                  << cacheFile << std::endl;
+        return true;
+    }
+
+    solvedBits.assign(bitBytes(target), 0);
+    solvedChance.assign((size_t)target * target, 0.0f);
+    double seconds = pigSolve(target, &solvedBits[0], &solvedChance[0]);
+    rollBits = &solvedBits[0];
+    winChance = &solvedChance[0];
+    tableTarget = target;
+    std::cout << "pig: solved the " << target << "-point game in "
+              << seconds * 1000 << " ms on " << jobsWorkers() + 1 << " threads"
+              << std::endl;
+
+    if (cacheFile != NULL) {
+        if (writeTable(target, cacheFile)) {
+            std::cout << "pig: table cached in " << cacheFile << std::endl;
+        }
+        else {
+            std::cerr << "pig: could not write " << cacheFile << std::endl;
+        }
+    }
+    return true;
+}
+
+// the directory the running executable is in, with a trailing separator;
+// empty if it cannot be found
+static std::string executableDirectory(void) {
+    char path[4096];
+#ifdef _WIN32
+    DWORD n = GetModuleFileNameA(NULL, path, sizeof(path));
+    if (n == 0 || n >= sizeof(path)) return "";
+    std::string s(path, n);
+    size_t slash = s.find_last_of("\\/");
+#else
+    ssize_t n = readlink("/proc/self/exe", path, sizeof(path));
+    if (n <= 0 || n >= (ssize_t)sizeof(path)) return "";
+    std::string s(path, n);
+    size_t slash = s.find_last_of('/');
+#endif
+    return slash == std::string::npos ? "" : s.substr(0, slash + 1);
+}
+
+std::string pigDefaultCacheFile(void) {
+#ifndef _WIN32
+    std::string dir;
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (xdg != NULL && xdg[0] == '/') dir = xdg;
+    else if (home != NULL && home[0] != '\0') dir = std::string(home) + "/.cache";
+    if (!dir.empty()) {
+        // make the directories, as far as they are missing
+        mkdir(dir.c_str(), 0755);
+        dir += "/asst5";
+        if (mkdir(dir.c_str(), 0755) == 0 || errno == EEXIST) {
+            return dir + "/pig.table";
+        }
+    }
+#endif
+    std::string exeDir = executableDirectory();
+    return exeDir.empty() ? "" : exeDir + "pig.table";
+}
+
+void pigShutdown(void) {
+    unmapTable();
+    solvedBits.clear();
+    solvedChance.clear();
+    rollBits = NULL;
+    winChance = NULL;
+    tableTarget = 0;
+}
+
+int pigTarget(void) {
+    return tableTarget;
+}
+
+bool pigShouldRoll(int score, int otherScore, int turnTotal) {
+    if (rollBits == NULL) return turnTotal < FALLBACK_HOLD_AT;
+    const int n = tableTarget;
+    if (score < 0 || otherScore < 0 || turnTotal < 0) return false;
+    if (score + turnTotal >= n || otherScore >= n) return false; // it is over
+    size_t bit = ((size_t)score * n + otherScore) * n + turnTotal;
+    return (rollBits[bit >> 3] >> (bit & 7)) & 1;
+}
+
+double pigWinChance(int score, int otherScore) {
+    const int n = tableTarget;
+    if (score >= n && n > 0) return 1;
+    if (otherScore >= n && n > 0) return 0;
+    if (winChance == NULL || score < 0 || otherScore < 0) return 0.5;
+    return winChance[score * n + otherScore];
+}
@@ -0,0 +1,63 @@
+/*
+ * The computer player for Pig: plays to maximize its chance of winning.
+ *
+ * The policy comes from solving the game exactly (after Neller and
+ * Presser's analysis of Pig).  P(i, j, k), the chance that the player
+ * about to act wins, with i points banked against the opponent's j and a
+ * turn total of k so far, is the larger of
+ *
+ *   hold:  1 - P(j, i + k, 0)
+ *   roll:  (1 - P(j, i, 0)) / 6 + (P(i, j, k + 2) + ... + P(i, j, k + 6)) / 6
+ *
+ * where any state with i + k at or past the target counts as a win.
+ * Holding or rolling a 1 hands the turn over without lowering the sum of
+ * the banked scores, so the states are solved in layers of equal i + j,
+ * highest first.  Within a layer, i against j refers only to the start of
+ * j's turn against i and back, so each such pair is a small fixed-point
+ * problem of its own: value iteration on it, sped up with secant steps,
+ * settles in a few tries, and the pairs of a layer are solved in parallel.
+ *
+ * The result is kept as one bit per state (roll or hold) and the chance
+ * of winning at the start of each turn: about 165 KB for a 100-point game.
+ * It is cached in a binary file, which later runs map into memory instead
+ * of solving again; a decision is then a single bit lookup.
+ */
+
+#ifndef __PIG_AI_H__
+#define __PIG_AI_H__
+
+#include <string>
+
+// load the table for a game to 'target' points from 'cacheFile', or, if
+// the file is missing or does not match, solve the game and write the
+// file; returns false (and the AI falls back to holding at 20) if no table
+// could be had
+bool pigInit(int target, const char* cacheFile);
+
+// where the table is cached unless told otherwise: pig.table in the user's
+// cache directory ($XDG_CACHE_HOME/asst5, or ~/.cache/asst5), or, failing
+// that, next to the executable; empty if neither can be found
+std::string pigDefaultCacheFile(void);
+
+// unmap or free the table
+void pigShutdown(void);
+
+// the table's target score, or 0 if there is no table
+int pigTarget(void);
+
+// should a player with 'score' points banked, against 'otherScore', and
+// 'turnTotal' so far this turn, roll again (rather than hold)?
+bool pigShouldRoll(int score, int otherScore, int turnTotal);
+
+// the chance that a player about to start a turn with 'score' points,
+// against 'otherScore', goes on to win (playing as above against a player
+// who does the same)
+double pigWinChance(int score, int otherScore);
+
+// solve a game to 'target' points and return its table, without touching
+// the one in use: 'rollBits' gets target^3 bits (state (i, j, k) is bit
+// (i * target + j) * target + k), 'winChance' target^2 values; returns the
+// seconds taken
+double pigSolve(int target, unsigned char* rollBits, float* winChance);
+
+#endif
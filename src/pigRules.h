@@ -0,0 +1,47 @@
+/*
+ * The rules of Pig, for every place that plays it: the game on screen
+ * (game.cpp), the table server and the strategy simulator.
+ *
+ * On a turn the player rolls as often as they like, adding each roll to
+ * the turn total; a 1 loses the turn total and ends the turn.  Holding
+ * banks the turn total and ends the turn.  The first to bank
+ * WINNING_SCORE wins, and a roll that brings the banked score plus the
+ * turn total there banks it at once.
+ *
+ * Plain integer code, with nothing to do with drawing, so that all three
+ * can share it; the simulator's SSE path follows the same rules four
+ * games at a time.
+ */
+
+#ifndef __PIG_RULES_H__
+#define __PIG_RULES_H__
+
+// the score that wins the game
+#define WINNING_SCORE 100
+
+// what became of the player to move
+enum PigOutcome {
+    PIG_ROLL_AGAIN, // the turn goes on
+    PIG_TURN_OVER,  // the turn has passed to the other player
+    PIG_WON         // the player has won
+};
+
+// bank the turn total
+inline PigOutcome pigBank(int& score, int& turnTotal) {
+    score += turnTotal;
+    turnTotal = 0;
+    return score >= WINNING_SCORE ? PIG_WON : PIG_TURN_OVER;
+}
+
+// count a roll of 'die' (1 to 6)
+inline PigOutcome pigApplyRoll(int& score, int& turnTotal, int die) {
+    if (die == 1) {
+        turnTotal = 0;
+        return PIG_TURN_OVER;
+    }
+    turnTotal += die;
+    if (score + turnTotal >= WINNING_SCORE) return pigBank(score, turnTotal);
+    return PIG_ROLL_AGAIN;
+}
+
+#endif
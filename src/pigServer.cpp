@@ -0,0 +1,521 @@
+/*
+ * Table server: hosts many games of Pig in one process, and a load
+ * generator to measure it.
+ */
+
+#include "pigServer.h"
+#include "pigAI.h"
+#include "pigRules.h"
+#include "rng.h"
+#include "frameClock.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#ifdef __linux__
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <sys/epoll.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+// one table's game, in four bytes: the server holds a great many.  Games
+// in play always have the player to move (the AI's turns are played out
+// at once).
+struct Table {
+    uint8_t score[2];   // the player's, the AI's
+    uint8_t turnTotal;  // the player's
+    uint8_t flags;      // SERVER_PLAYER_WON, SERVER_AI_WON
+};
+
+static void newGame(Table& t) {
+    t.score[0] = t.score[1] = 0;
+    t.turnTotal = 0;
+    t.flags = 0;
+}
+
+// the AI plays its turn (see pigRules.h); returns how many times it rolled
+static int aiTurn(Table& t, Rng& rng) {
+    int rolls = 0, score = t.score[1], total = 0;
+    PigOutcome outcome = PIG_ROLL_AGAIN;
+    while (outcome == PIG_ROLL_AGAIN) {
+        if (pigShouldRoll(score, t.score[0], total)) {
+            outcome = pigApplyRoll(score, total, rng.range(1, 6));
+            rolls++;
+        }
+        else {
+            outcome = pigBank(score, total);
+        }
+    }
+    t.score[1] = (uint8_t)score;
+    if (outcome == PIG_WON) t.flags |= SERVER_AI_WON;
+    return rolls;
+}
+
+// the player's turn is over, with 'outcome': unless the player has won,
+// the AI takes its turn; returns how many times it rolled
+static int endTurn(Table& t, PigOutcome outcome, Rng& rng) {
+    if (outcome == PIG_WON) {
+        t.flags |= SERVER_PLAYER_WON;
+        return 0;
+    }
+    return aiTurn(t, rng);
+}
+
+static inline uint32_t readU32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void writeU32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+// carry out one request, writing its reply
+static void serve(std::vector<Table>& tables, Rng& rng,
+                  const unsigned char* request, unsigned char* reply) {
+    uint32_t id = readU32(request);
+    int op = request[4];
+    memset(reply, 0, SERVER_REPLY_SIZE);
+    writeU32(reply, id);
+    if (id >= tables.size()) {
+        reply[4] = SERVER_NO_TABLE;
+        return;
+    }
+
+    Table& t = tables[id];
+    int die = 0, aiRolls = 0;
+    int status = SERVER_OK;
+    switch (op) {
+    case SERVER_NEW_GAME:
+        newGame(t);
+        break;
+    case SERVER_ROLL:
+    case SERVER_HOLD:
+        if (t.flags != 0) {
+            status = SERVER_GAME_OVER;
+        }
+        else {
+            int score = t.score[0], total = t.turnTotal;
+            PigOutcome outcome;
+            if (op == SERVER_ROLL) {
+                die = rng.range(1, 6);
+                outcome = pigApplyRoll(score, total, die);
+            }
+            else {
+                outcome = pigBank(score, total);
+            }
+            t.score[0] = (uint8_t)score;
+            t.turnTotal = (uint8_t)total;
+            if (outcome != PIG_ROLL_AGAIN) aiRolls = endTurn(t, outcome, rng);
+        }
+        break;
+    case SERVER_STATE:
+        break;
+    default:
+        status = SERVER_BAD_REQUEST;
+        break;
+    }
+    reply[4] = (unsigned char)status;
+    reply[5] = (unsigned char)die;
+    reply[6] = t.score[0];
+    reply[7] = t.score[1];
+    reply[8] = t.turnTotal;
+    reply[9] = t.flags;
+    reply[10] = (unsigned char)std::min(aiRolls, 255);
+}
+
+#ifdef __linux__
+
+// the most bytes read from a connection at once, and the most replies
+// left unsent before the server stops reading its requests
+static const size_t READ_SIZE = 64 * 1024;
+static const size_t MAX_UNSENT = 1024 * 1024;
+
+// events handled per epoll_wait
+static const int MAX_EVENTS = 256;
+
+// a connection: bytes received but not yet a whole request, and replies
+// not yet sent
+struct Connection {
+    int fd;
+    std::vector<unsigned char> in;
+    std::vector<unsigned char> out;
+    size_t sent;          // bytes of 'out' already sent
+    bool waitingToWrite;  // registered for EPOLLOUT
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int) {
+    stopRequested = 1;
+}
+
+// a Unix-domain socket address for 'path'; false if it is too long
+static bool socketAddress(const char* path, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        std::cerr << "socket path too long: " << path << std::endl;
+        return false;
+    }
+    strcpy(address.sun_path, path);
+    return true;
+}
+
+// clear the way to listen at 'address': nothing there, or a socket left
+// over from a server that has gone (nothing accepts connections on it),
+// which is removed.  Anything else there is reported, and left alone.
+static bool claimSocketPath(const sockaddr_un& address) {
+    const char* path = address.sun_path;
+    struct stat st;
+    if (lstat(path, &st) != 0) {
+        if (errno == ENOENT) return true;
+        std::cerr << "serve: cannot check " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        std::cerr << "serve: " << path << " exists and is not a socket" << std::endl;
+        return false;
+    }
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool stale = probe >= 0 && connect(probe, (sockaddr*)&address, sizeof(address)) != 0
+        && errno == ECONNREFUSED;
+    if (probe >= 0) close(probe);
+    if (!stale) {
+        std::cerr << "serve: " << path << " is in use (is another server running?)"
+                  << std::endl;
+        return false;
+    }
+    if (unlink(path) != 0) {
+        std::cerr << "serve: cannot remove " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// send as much of c.out as the socket will take; false if the connection
+// has failed
+static bool flush(Connection& c) {
+    while (c.sent < c.out.size()) {
+        ssize_t n = send(c.fd, &c.out[c.sent], c.out.size() - c.sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        c.sent += (size_t)n;
+    }
+    if (c.sent == c.out.size()) {
+        c.out.clear();
+        c.sent = 0;
+    }
+    return true;
+}
+
+// watch for what the connection needs next: reading, unless too many
+// replies are waiting, and writing, while any are
+static void watch(int epoll, Connection& c) {
+    size_t unsent = c.out.size() - c.sent;
+    epoll_event event;
+    event.events = (unsent < MAX_UNSENT ? EPOLLIN : 0) | (unsent > 0 ? EPOLLOUT : 0);
+    event.data.ptr = &c;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, c.fd, &event);
+    c.waitingToWrite = unsent > 0;
+}
+
+// read what has arrived and answer every whole request in it; false if
+// the connection is closed or has failed
+static bool readRequests(Connection& c, std::vector<Table>& tables, Rng& rng,
+                         long long& served) {
+    size_t have = c.in.size();
+    c.in.resize(have + READ_SIZE);
+    ssize_t n = recv(c.fd, &c.in[have], READ_SIZE, 0);
+    if (n <= 0) {
+        c.in.resize(have);
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+    have += (size_t)n;
+
+    size_t requests = have / SERVER_REQUEST_SIZE;
+    size_t replyAt = c.out.size();
+    c.out.resize(replyAt + requests * SERVER_REPLY_SIZE);
+    for (size_t r = 0; r < requests; r++) {
+        serve(tables, rng, &c.in[r * SERVER_REQUEST_SIZE],
+              &c.out[replyAt + r * SERVER_REPLY_SIZE]);
+    }
+    served += (long long)requests;
+
+    // keep any part of a request for next time
+    size_t used = requests * SERVER_REQUEST_SIZE;
+    c.in.resize(have);
+    c.in.erase(c.in.begin(), c.in.begin() + used);
+    return true;
+}
+
+static void closeConnection(int epoll, Connection* c) {
+    epoll_ctl(epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    delete c;
+}
+
+int runServer(const ServerOptions& options) {
+    if (options.tables <= 0) {
+        std::cerr << "serve: the number of tables must be positive" << std::endl;
+        return 1;
+    }
+    std::vector<Table> tables(options.tables);
+    for (size_t i = 0; i < tables.size(); i++) newGame(tables[i]);
+    Rng rng(options.seed);
+
+    sockaddr_un address;
+    if (!socketAddress(options.socketPath, address) || !claimSocketPath(address)) {
+        return 1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0
+        || listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "serve: cannot listen on " << options.socketPath << ": "
+                  << strerror(errno) << std::endl;
+        if (listener >= 0) close(listener);
+        return 1;
+    }
+
+    int epoll = epoll_create1(0);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL; // the listener
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+    std::cout << "serve: " << options.tables << " tables on " << options.socketPath
+              << " (interrupt to stop)" << std::endl;
+
+    long long served = 0;
+    int connections = 0;
+    double start = clockNow();
+    epoll_event events[MAX_EVENTS];
+    while (!stopRequested) {
+        int count = epoll_wait(epoll, events, MAX_EVENTS, 1000);
+        for (int e = 0; e < count; e++) {
+            Connection* c = (Connection*)events[e].data.ptr;
+            if (c == NULL) {
+                int fd;
+                while ((fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+                    c = new Connection();
+                    c->fd = fd;
+                    c->sent = 0;
+                    c->waitingToWrite = false;
+                    event.events = EPOLLIN;
+                    event.data.ptr = c;
+                    epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+                    connections++;
+                }
+                continue;
+            }
+
+            bool ok = true;
+            if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                ok = readRequests(*c, tables, rng, served);
+            }
+            // replies go out in one send per batch of requests
+            if (ok) ok = flush(*c);
+            if (!ok) {
+                closeConnection(epoll, c);
+                continue;
+            }
+            bool mustWait = c->out.size() > c->sent;
+            if (mustWait != c->waitingToWrite || c->out.size() - c->sent >= MAX_UNSENT) {
+                watch(epoll, *c);
+            }
+        }
+    }
+
+    double seconds = clockNow() - start;
+    std::cout << "serve: " << served << " requests from " << connections
+              << " connections in " << seconds << " s ("
+              << (seconds > 0 ? served / seconds : 0) << " requests/s)" << std::endl;
+    close(epoll);
+    close(listener);
+    unlink(options.socketPath);
+    return 0;
+}
+
+//----------------------------------------------------------------------------
+//  Load generator
+//----------------------------------------------------------------------------
+
+// one connection's share of the tables, each with one request in flight
+struct Player {
+    int fd;
+    uint32_t firstTable;
+    std::vector<double> sentAt;     // when each table's request went out
+    std::vector<unsigned char> in;  // a part of a reply
+    std::vector<unsigned char> out;
+    size_t sent;
+};
+
+// the player's next move on a table, from the reply: hold at 20 (the
+// server banks a winning total by itself)
+static int nextMove(const unsigned char* reply) {
+    if (reply[4] != SERVER_OK || reply[9] != 0) return SERVER_NEW_GAME;
+    return reply[8] < 20 ? SERVER_ROLL : SERVER_HOLD;
+}
+
+static void queueRequest(Player& p, uint32_t table, int op, double now) {
+    unsigned char request[SERVER_REQUEST_SIZE] = { 0 };
+    writeU32(request, table);
+    request[4] = (unsigned char)op;
+    p.out.insert(p.out.end(), request, request + SERVER_REQUEST_SIZE);
+    p.sentAt[table - p.firstTable] = now;
+}
+
+// send what the socket will take; false if the connection has failed
+static bool flush(Player& p) {
+    while (p.sent < p.out.size()) {
+        ssize_t n = send(p.fd, &p.out[p.sent], p.out.size() - p.sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p.sent += (size_t)n;
+    }
+    if (p.sent == p.out.size()) {
+        p.out.clear();
+        p.sent = 0;
+    }
+    return true;
+}
+
+// replies whose latency is kept: one in this many
+static const int LATENCY_SAMPLING = 16;
+
+int runLoadGenerator(const LoadOptions& options) {
+    if (options.connections <= 0 || options.tables < options.connections) {
+        std::cerr << "loadgen: need at least one table per connection" << std::endl;
+        return 1;
+    }
+    sockaddr_un address;
+    if (!socketAddress(options.socketPath, address)) return 1;
+
+    // connect, and start a game on every table
+    int epoll = epoll_create1(0);
+    std::vector<Player> players(options.connections);
+    uint32_t table = 0;
+    double now = clockNow();
+    for (int i = 0; i < options.connections; i++) {
+        Player& p = players[i];
+        p.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (p.fd < 0 || connect(p.fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            std::cerr << "loadgen: cannot connect to " << options.socketPath << ": "
+                      << strerror(errno) << std::endl;
+            return 1;
+        }
+        fcntl(p.fd, F_SETFL, fcntl(p.fd, F_GETFL, 0) | O_NONBLOCK);
+        int share = options.tables / options.connections
+                    + (i < options.tables % options.connections);
+        p.firstTable = table;
+        p.sentAt.resize(share);
+        p.sent = 0;
+        for (int t = 0; t < share; t++) queueRequest(p, table + t, SERVER_NEW_GAME, now);
+        table += share;
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.ptr = &p;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, p.fd, &event);
+    }
+
+    // every reply brings the table's next request, until time is up; then
+    // the replies still to come are collected
+    long long inFlight = options.tables, replies = 0, errors = 0;
+    long long won[2] = { 0, 0 }; // by the player, by the AI
+    std::vector<float> latencies;
+    double start = now, stop = start + options.seconds;
+    epoll_event events[MAX_EVENTS];
+    while (inFlight > 0) {
+        int count = epoll_wait(epoll, events, MAX_EVENTS, 100);
+        now = clockNow();
+        bool playing = now < stop;
+        if (!playing && now > stop + 5) break; // the server has stopped answering
+        for (int e = 0; e < count; e++) {
+            Player& p = *(Player*)events[e].data.ptr;
+            if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                size_t have = p.in.size();
+                p.in.resize(have + READ_SIZE);
+                ssize_t n = recv(p.fd, &p.in[have], READ_SIZE, 0);
+                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+                    std::cerr << "loadgen: the server closed the connection" << std::endl;
+                    return 1;
+                }
+                have += n > 0 ? (size_t)n : 0;
+                size_t whole = have / SERVER_REPLY_SIZE;
+                for (size_t r = 0; r < whole; r++) {
+                    const unsigned char* reply = &p.in[r * SERVER_REPLY_SIZE];
+                    uint32_t t = readU32(reply);
+                    if (reply[4] != SERVER_OK) errors++;
+                    if (reply[9] & SERVER_PLAYER_WON) won[0]++;
+                    if (reply[9] & SERVER_AI_WON) won[1]++;
+                    if (replies++ % LATENCY_SAMPLING == 0) {
+                        latencies.push_back((float)(now - p.sentAt[t - p.firstTable]));
+                    }
+                    inFlight--;
+                    if (playing) {
+                        queueRequest(p, t, nextMove(reply), now);
+                        inFlight++;
+                    }
+                }
+                size_t used = whole * SERVER_REPLY_SIZE;
+                p.in.resize(have);
+                p.in.erase(p.in.begin(), p.in.begin() + used);
+            }
+            if (!flush(p)) {
+                std::cerr << "loadgen: cannot send to the server" << std::endl;
+                return 1;
+            }
+            epoll_event event;
+            event.events = EPOLLIN | (p.out.size() > p.sent ? EPOLLOUT : 0);
+            event.data.ptr = &p;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, p.fd, &event);
+        }
+    }
+    double seconds = clockNow() - start;
+    for (size_t i = 0; i < players.size(); i++) close(players[i].fd);
+    close(epoll);
+
+    std::sort(latencies.begin(), latencies.end());
+    double p50 = latencies.empty() ? 0 : latencies[latencies.size() / 2];
+    double p99 = latencies.empty() ? 0 : latencies[(size_t)(latencies.size() * 0.99)];
+    long long games = won[0] + won[1];
+    printf("loadgen: %d connections, %d tables, %.2f s\n", options.connections,
+           options.tables, seconds);
+    printf("  %lld requests (%.0f/s), %lld refused\n", replies,
+           seconds > 0 ? replies / seconds : 0, errors);
+    printf("  %lld games (%.0f/s), hold20 won %.2f%% against the AI\n", games,
+           seconds > 0 ? games / seconds : 0, games > 0 ? 100.0 * won[0] / games : 0);
+    printf("  reply latency: p50 %.3f ms, p99 %.3f ms\n", p50 * 1000, p99 * 1000);
+    return 0;
+}
+
+#else // no epoll on this platform
+
+int runServer(const ServerOptions&) {
+    std::cerr << "serve: not supported on this platform" << std::endl;
+    return 1;
+}
+
+int runLoadGenerator(const LoadOptions&) {
+    std::cerr << "loadgen: not supported on this platform" << std::endl;
+    return 1;
+}
+
+#endif
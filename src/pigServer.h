@@ -0,0 +1,84 @@
+/*
+ * Table server: hosts many games of Pig in one process, each a client
+ * (the player) against the AI, for bots and other programs to play over a
+ * Unix-domain socket; and a load generator that plays as many tables as
+ * it can, to measure the server.
+ *
+ * The protocol is fixed-size binary messages, with multi-byte numbers
+ * little-endian.  A request is 8 bytes:
+ *
+ *   0-3  table number
+ *   4    operation: SERVER_NEW_GAME, SERVER_ROLL, SERVER_HOLD or SERVER_STATE
+ *   5-7  zero
+ *
+ * and each gets, in order, a 12-byte reply:
+ *
+ *   0-3  table number
+ *   4    status: SERVER_OK, or why the request was refused
+ *   5    the player's roll (0 if there was none)
+ *   6    the player's score
+ *   7    the AI's score
+ *   8    the player's turn total
+ *   9    flags: SERVER_PLAYER_WON, SERVER_AI_WON
+ *   10   how many times the AI rolled in answer
+ *   11   zero
+ *
+ * The rules are the game's.  When the turn passes to the AI, it plays its
+ * whole turn (as pigAI decides) before the reply is sent, so the player
+ * is always the one to move in a game still going.  A client may send
+ * many requests without waiting for replies; they are read, carried out
+ * and answered in batches.
+ *
+ * The server is one thread running a Linux epoll loop; on other platforms
+ * both modes report failure.
+ */
+
+#ifndef __PIG_SERVER_H__
+#define __PIG_SERVER_H__
+
+// operations
+enum {
+    SERVER_NEW_GAME = 0, // start the table's game over
+    SERVER_ROLL = 1,
+    SERVER_HOLD = 2,
+    SERVER_STATE = 3     // change nothing, just report
+};
+
+// statuses
+enum {
+    SERVER_OK = 0,
+    SERVER_NO_TABLE = 1,   // no such table
+    SERVER_GAME_OVER = 2,  // roll or hold in a game someone has won
+    SERVER_BAD_REQUEST = 3 // no such operation
+};
+
+// flags
+enum {
+    SERVER_PLAYER_WON = 1,
+    SERVER_AI_WON = 2
+};
+
+#define SERVER_REQUEST_SIZE 8
+#define SERVER_REPLY_SIZE 12
+
+struct ServerOptions {
+    const char* socketPath;
+    int tables;               // number of tables hosted
+    unsigned long long seed;  // seed for the dice
+};
+
+struct LoadOptions {
+    const char* socketPath;
+    int connections;          // connections to the server, all in use at once
+    int tables;               // tables played, shared among the connections
+    double seconds;           // how long to play
+};
+
+// host tables until interrupted; returns the process exit status
+int runServer(const ServerOptions& options);
+
+// play tables on a running server, holding at 20, and report requests per
+// second and reply latency; returns the process exit status
+int runLoadGenerator(const LoadOptions& options);
+
+#endif
@@ -0,0 +1,282 @@
+/*
+ * Strategy simulator: plays Pig between two strategies, with no graphics,
+ * as many games as asked for, and reports how often each wins.
+ */
+
+#include "pigSim.h"
+#include "pigAI.h"
+#include "pigRules.h"
+#include "jobs.h"
+#include "rng.h"
+#include "frameClock.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define SIM_SSE 1
+#endif
+
+// games played side by side in a batch (a multiple of four), and how many
+// each of them plays in turn; a batch is one job
+static const int BATCH_LANES = 1024;
+static const int GAMES_PER_LANE = 64;
+static const long long BATCH_GAMES = (long long)BATCH_LANES * GAMES_PER_LANE;
+
+// for the confidence intervals: 95%
+static const double Z = 1.959964;
+
+// the games in a batch, one array per field; the player to move (0 or 1:
+// which strategy) is always the one whose score is 'banked'
+struct Lanes {
+    int32_t banked[BATCH_LANES];
+    int32_t other[BATCH_LANES];
+    int32_t turnTotal[BATCH_LANES];
+    int32_t mover[BATCH_LANES];
+    int32_t gamesLeft[BATCH_LANES]; // 0: this lane is finished
+    int32_t roll[BATCH_LANES];      // this step's choice: -1 roll, 0 hold
+    uint32_t die[BATCH_LANES];      // this step's roll, less one
+};
+
+// what one batch came to
+struct BatchResult {
+    long long wins[2];
+    long long rolls;
+};
+
+bool parseStrategy(const char* text, PigStrategy& strategy) {
+    if (strcmp(text, "optimal") == 0) {
+        strategy.holdAt = 0;
+        return true;
+    }
+    if (strncmp(text, "hold", 4) == 0 && atoi(text + 4) > 0) {
+        strategy.holdAt = atoi(text + 4);
+        return true;
+    }
+    return false;
+}
+
+static void strategyName(const PigStrategy& strategy, char* name, size_t size) {
+    if (strategy.holdAt == 0) snprintf(name, size, "optimal");
+    else snprintf(name, size, "hold%d", strategy.holdAt);
+}
+
+// start a new game in lane l; the player who starts alternates
+static inline void newGame(Lanes& s, int l) {
+    s.banked[l] = 0;
+    s.other[l] = 0;
+    s.turnTotal[l] = 0;
+    s.mover[l] = (s.gamesLeft[l] + l) & 1;
+}
+
+// every game's choice: roll or hold
+static void decide(Lanes& s, const PigStrategy* strategies) {
+    int l = 0;
+    if (strategies[0].holdAt > 0 && strategies[1].holdAt > 0) {
+        // hold at a fixed total: roll while turnTotal < holdAt and a hold
+        // would not win
+#ifdef SIM_SSE
+        const __m128i holdAt0 = _mm_set1_epi32(strategies[0].holdAt);
+        const __m128i holdAt1 = _mm_set1_epi32(strategies[1].holdAt);
+        const __m128i target = _mm_set1_epi32(WINNING_SCORE);
+        for (; l < BATCH_LANES; l += 4) {
+            __m128i t = _mm_loadu_si128((const __m128i*)&s.turnTotal[l]);
+            __m128i a = _mm_loadu_si128((const __m128i*)&s.banked[l]);
+            __m128i second = _mm_sub_epi32(_mm_setzero_si128(),
+                                           _mm_loadu_si128((const __m128i*)&s.mover[l]));
+            __m128i holdAt = _mm_or_si128(_mm_andnot_si128(second, holdAt0),
+                                          _mm_and_si128(second, holdAt1));
+            __m128i roll = _mm_and_si128(_mm_cmplt_epi32(t, holdAt),
+                                         _mm_cmplt_epi32(_mm_add_epi32(a, t), target));
+            _mm_storeu_si128((__m128i*)&s.roll[l], roll);
+        }
+#endif
+        for (; l < BATCH_LANES; l++) {
+            int holdAt = strategies[s.mover[l]].holdAt;
+            s.roll[l] = -(s.turnTotal[l] < holdAt && s.banked[l] + s.turnTotal[l] < WINNING_SCORE);
+        }
+    }
+    else {
+        // a table lookup for each game that plays by the solved game
+        for (; l < BATCH_LANES; l++) {
+            int holdAt = strategies[s.mover[l]].holdAt;
+            bool roll = holdAt > 0
+                ? s.turnTotal[l] < holdAt && s.banked[l] + s.turnTotal[l] < WINNING_SCORE
+                : pigShouldRoll(s.banked[l], s.other[l], s.turnTotal[l]);
+            s.roll[l] = -(int32_t)roll;
+        }
+    }
+}
+
+// a game has been won by its player to move: count it, and start the next
+static inline void gameWon(Lanes& s, int l, BatchResult& result) {
+    result.wins[s.mover[l]]++;
+    if (--s.gamesLeft[l] > 0) newGame(s, l);
+}
+
+// carry out every game's choice, by the rules in pigRules.h.  A hold banks
+// the turn total and a roll of 1 loses it; either hands the turn over,
+// swapping the scores.  Banking (by a hold, or by a roll that reaches the
+// target) may instead win.
+static void play(Lanes& s, BatchResult& result) {
+    int l = 0;
+#ifdef SIM_SSE
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i target = _mm_set1_epi32(WINNING_SCORE);
+    __m128i rolls = _mm_setzero_si128(); // per lane
+    for (; l < BATCH_LANES; l += 4) {
+        __m128i active = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&s.gamesLeft[l]),
+                                         _mm_setzero_si128());
+        __m128i roll = _mm_and_si128(active, _mm_loadu_si128((const __m128i*)&s.roll[l]));
+        __m128i hold = _mm_andnot_si128(roll, active);
+        __m128i die = _mm_add_epi32(_mm_loadu_si128((const __m128i*)&s.die[l]), one);
+        __m128i a = _mm_loadu_si128((const __m128i*)&s.banked[l]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&s.other[l]);
+        __m128i t = _mm_loadu_si128((const __m128i*)&s.turnTotal[l]);
+        __m128i mover = _mm_loadu_si128((const __m128i*)&s.mover[l]);
+
+        __m128i pig = _mm_and_si128(roll, _mm_cmpeq_epi32(die, one));
+        __m128i rolled = _mm_add_epi32(t, _mm_and_si128(roll, die));
+        __m128i reached = _mm_andnot_si128(_mm_cmplt_epi32(_mm_add_epi32(a, rolled), target),
+                                           _mm_andnot_si128(pig, roll));
+        __m128i bank = _mm_or_si128(hold, reached);
+        __m128i banked = _mm_add_epi32(a, _mm_and_si128(bank, rolled));
+        __m128i won = _mm_andnot_si128(_mm_cmplt_epi32(banked, target), bank);
+        __m128i endTurn = _mm_or_si128(_mm_or_si128(hold, pig), won);
+
+        t = _mm_andnot_si128(endTurn, rolled);
+        __m128i newA = _mm_or_si128(_mm_andnot_si128(endTurn, banked), _mm_and_si128(endTurn, b));
+        __m128i newB = _mm_or_si128(_mm_andnot_si128(endTurn, b), _mm_and_si128(endTurn, banked));
+        // a winner stays the player to move, so gameWon() can credit it
+        __m128i swap = _mm_andnot_si128(won, endTurn);
+        _mm_storeu_si128((__m128i*)&s.banked[l], _mm_or_si128(_mm_andnot_si128(won, newA),
+                                                               _mm_and_si128(won, banked)));
+        _mm_storeu_si128((__m128i*)&s.other[l], newB);
+        _mm_storeu_si128((__m128i*)&s.turnTotal[l], t);
+        _mm_storeu_si128((__m128i*)&s.mover[l], _mm_xor_si128(mover, _mm_and_si128(swap, one)));
+        rolls = _mm_sub_epi32(rolls, roll);
+
+        int wonLanes = _mm_movemask_ps(_mm_castsi128_ps(won));
+        for (int k = 0; wonLanes != 0; k++, wonLanes >>= 1) {
+            if (wonLanes & 1) gameWon(s, l + k, result);
+        }
+    }
+    int32_t laneRolls[4];
+    _mm_storeu_si128((__m128i*)laneRolls, rolls);
+    result.rolls += (long long)laneRolls[0] + laneRolls[1] + laneRolls[2] + laneRolls[3];
+#endif
+    for (; l < BATCH_LANES; l++) {
+        if (s.gamesLeft[l] <= 0) continue;
+        int banked = s.banked[l], t = s.turnTotal[l];
+        PigOutcome outcome;
+        if (s.roll[l]) {
+            result.rolls++;
+            outcome = pigApplyRoll(banked, t, (int)s.die[l] + 1);
+        }
+        else {
+            outcome = pigBank(banked, t);
+        }
+        s.turnTotal[l] = t;
+        if (outcome == PIG_ROLL_AGAIN) continue;
+        if (outcome == PIG_WON) {
+            s.banked[l] = banked;
+            gameWon(s, l, result);
+            continue;
+        }
+        s.banked[l] = s.other[l];
+        s.other[l] = banked;
+        s.mover[l] ^= 1;
+    }
+}
+
+// play one batch's games: 'games' of them, from stream 'stream' of the seed
+static BatchResult playBatch(const SimulationOptions& options, long long games,
+                             uint64_t stream) {
+    static thread_local Lanes s;
+    BatchResult result = { { 0, 0 }, 0 };
+    Rng rng(options.seed, stream);
+
+    int busy = 0; // lanes with games to play
+    for (int l = 0; l < BATCH_LANES; l++) {
+        s.gamesLeft[l] = (int32_t)(games / BATCH_LANES + (l < games % BATCH_LANES));
+        if (s.gamesLeft[l] > 0) busy++;
+        newGame(s, l);
+    }
+    while (busy > 0) {
+        decide(s, options.strategies);
+        rng.fillBelow(s.die, BATCH_LANES, 6);
+        play(s, result);
+        // lanes run out at about the same time; count the rest only once
+        // the first have
+        if (result.wins[0] + result.wins[1] >= games - BATCH_LANES) {
+            busy = 0;
+            for (int l = 0; l < BATCH_LANES; l++) busy += s.gamesLeft[l] > 0;
+        }
+    }
+    return result;
+}
+
+// Wilson score interval for a proportion
+static void confidence(long long successes, long long trials, double& lo, double& hi) {
+    if (trials == 0) {
+        lo = 0;
+        hi = 1;
+        return;
+    }
+    double n = (double)trials, p = successes / n;
+    double center = (p + Z * Z / (2 * n)) / (1 + Z * Z / n);
+    double spread = Z * sqrt(p * (1 - p) / n + Z * Z / (4 * n * n)) / (1 + Z * Z / n);
+    lo = center - spread;
+    hi = center + spread;
+}
+
+int runSimulation(const SimulationOptions& options) {
+    if (options.games <= 0) {
+        std::cerr << "simulate: the number of games must be positive" << std::endl;
+        return 1;
+    }
+    for (int p = 0; p < 2; p++) {
+        if (options.strategies[p].holdAt == 0 && pigTarget() != WINNING_SCORE) {
+            std::cerr << "simulate: no solved game for the optimal strategy" << std::endl;
+            return 1;
+        }
+    }
+
+    int batches = (int)((options.games + BATCH_GAMES - 1) / BATCH_GAMES);
+    std::vector<BatchResult> results(batches);
+    double start = clockNow();
+    parallelFor(batches, 1, [&](int begin, int end) {
+        for (int b = begin; b < end; b++) {
+            long long games = options.games - b * BATCH_GAMES;
+            results[b] = playBatch(options, games < BATCH_GAMES ? games : BATCH_GAMES, b);
+        }
+    });
+    double seconds = clockNow() - start;
+
+    BatchResult total = { { 0, 0 }, 0 };
+    for (int b = 0; b < batches; b++) {
+        total.wins[0] += results[b].wins[0];
+        total.wins[1] += results[b].wins[1];
+        total.rolls += results[b].rolls;
+    }
+
+    char names[2][32];
+    strategyName(options.strategies[0], names[0], sizeof(names[0]));
+    strategyName(options.strategies[1], names[1], sizeof(names[1]));
+    printf("%lld games, %s against %s, seed %llu\n", options.games, names[0], names[1],
+           options.seed);
+    for (int p = 0; p < 2; p++) {
+        double lo, hi;
+        confidence(total.wins[p], options.games, lo, hi);
+        printf("  %-10s wins %6.3f%% (95%% confidence: %.3f%% to %.3f%%)\n", names[p],
+               100.0 * total.wins[p] / options.games, 100 * lo, 100 * hi);
+    }
+    printf("  %.1f rolls per game\n", (double)total.rolls / options.games);
+    printf("  %.3f s on %d threads: %.0f games/s\n", seconds, jobsWorkers() + 1,
+           seconds > 0 ? options.games / seconds : 0);
+    return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * Strategy simulator: plays Pig between two strategies, with no graphics,
+ * as many games as asked for, and reports how often each wins.
+ *
+ * The rules are the game's: a roll of 1 ends the turn and loses the turn
+ * total, holding banks it, and WINNING_SCORE wins.  Whoever starts
+ * alternates from one game to the next.
+ *
+ * Games are played in batches of BATCH_LANES at once, their state kept as
+ * one array per field; every step, every game in the batch makes its
+ * choice and rolls, four games to an SSE2 register where available.  Each
+ * batch draws its dice from its own stream of the seed, so a run's result
+ * depends only on the options, not on the number of threads.
+ */
+
+#ifndef __PIG_SIM_H__
+#define __PIG_SIM_H__
+
+// a way to play: hold once the turn total reaches 'holdAt', or, if it is
+// 0, as the solved game says (see pigAI.h); either way, hold when that
+// would win
+struct PigStrategy {
+    int holdAt;
+};
+
+struct SimulationOptions {
+    long long games;          // number of games to play
+    unsigned long long seed;  // seed for the dice
+    PigStrategy strategies[2];
+};
+
+// read a strategy: "optimal", or "holdN" for hold at N; false if it is
+// neither
+bool parseStrategy(const char* text, PigStrategy& strategy);
+
+// run the simulation and print the results; returns the process exit
+// status
+int runSimulation(const SimulationOptions& options);
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Profiler: records where frame time goes, on the CPU (every thread) and
+ * on the GPU, for viewing as a timeline.
+ */
+
+#include "cs432.h"
+#include "profiler.h"
+#include <stdio.h>
+
+#ifdef ASST5_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+// zones kept per thread (a power of two), and the most threads recorded
+static const uint64_t RING_EVENTS = 65536;
+static const int MAX_RINGS = 64;
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t start, end; // nanoseconds
+};
+
+// one thread's zones.  Only that thread writes; 'count' (the number ever
+// written) is published after each event, so a reader sees whole events.
+struct ProfileRing {
+    ProfileEvent events[RING_EVENTS];
+    std::atomic<uint64_t> count;
+    int id;
+};
+
+// the rings, each added once by its thread and never removed; the GPU's
+// zones have a ring of their own, filled by the thread with the context
+static ProfileRing* rings[MAX_RINGS];
+static std::atomic<int> ringCount(0);
+static ProfileRing* gpuRing = NULL;
+
+static const std::chrono::steady_clock::time_point startTime =
+    std::chrono::steady_clock::now();
+
+uint64_t profileNow(void) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+static ProfileRing* newRing(void) {
+    if (ringCount.load() >= MAX_RINGS) return NULL;
+    ProfileRing* ring = new ProfileRing();
+    ring->count.store(0);
+    int id = ringCount.fetch_add(1);
+    if (id >= MAX_RINGS) { // another thread took the last place
+        delete ring;
+        return NULL;
+    }
+    ring->id = id;
+    rings[id] = ring;
+    return ring;
+}
+
+static inline void record(ProfileRing* ring, const char* name, uint64_t start, uint64_t end) {
+    if (ring == NULL) return;
+    uint64_t n = ring->count.load(std::memory_order_relaxed);
+    ProfileEvent& e = ring->events[n & (RING_EVENTS - 1)];
+    e.name = name;
+    e.start = start;
+    e.end = end;
+    ring->count.store(n + 1, std::memory_order_release);
+}
+
+void profileRecord(const char* name, uint64_t start, uint64_t end) {
+    static thread_local ProfileRing* ring = newRing();
+    record(ring, name, start, end);
+}
+
+//----------------------------------------------------------------------------
+//  GPU zones
+//----------------------------------------------------------------------------
+
+// a GPU zone: timestamp queries at its start and end
+struct GpuZone {
+    const char* name;
+    GLuint queries[2];
+};
+
+static int gpuTiming = -1;          // 1 if timer queries work, -1 before we know
+static int64_t gpuOffset = 0;       // CPU time less GPU time, in nanoseconds
+static std::vector<GpuZone> gpuZones;
+static std::vector<int> gpuFree;    // zones not in use
+static std::vector<int> gpuPending; // ended, in order, results still to come
+
+// can we time the GPU? If so, line its clock up with ours
+static bool gpuAvailable(void) {
+    if (gpuTiming < 0) {
+        gpuTiming = glVersionAtLeast(3, 3) || glHasExtension("GL_ARB_timer_query");
+        if (gpuTiming) {
+            GLint64 gpuNow = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+            gpuOffset = (int64_t)profileNow() - gpuNow;
+            gpuRing = newRing();
+        }
+    }
+    return gpuTiming > 0;
+}
+
+int profileGpuBegin(const char* name) {
+    if (!gpuAvailable()) return -1;
+    int zone;
+    if (!gpuFree.empty()) {
+        zone = gpuFree.back();
+        gpuFree.pop_back();
+    }
+    else {
+        GpuZone z;
+        glGenQueries(2, z.queries);
+        gpuZones.push_back(z);
+        zone = (int)gpuZones.size() - 1;
+    }
+    gpuZones[zone].name = name;
+    glQueryCounter(gpuZones[zone].queries[0], GL_TIMESTAMP);
+    return zone;
+}
+
+void profileGpuEnd(int zone) {
+    if (zone < 0) return;
+    glQueryCounter(gpuZones[zone].queries[1], GL_TIMESTAMP);
+    gpuPending.push_back(zone);
+}
+
+void profileFrame(void) {
+    // results come in the order the queries were issued, so stop at the
+    // first that is not ready rather than waiting for it
+    size_t done = 0;
+    for (; done < gpuPending.size(); done++) {
+        GpuZone& z = gpuZones[gpuPending[done]];
+        GLint ready = 0;
+        glGetQueryObjectiv(z.queries[1], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (!ready) break;
+        GLuint64 start = 0, end = 0;
+        glGetQueryObjectui64v(z.queries[0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(z.queries[1], GL_QUERY_RESULT, &end);
+        record(gpuRing, z.name, start + gpuOffset, end + gpuOffset);
+        gpuFree.push_back(gpuPending[done]);
+    }
+    gpuPending.erase(gpuPending.begin(), gpuPending.begin() + done);
+}
+
+//----------------------------------------------------------------------------
+
+bool profileWriteTrace(const char* filename) {
+    FILE* fp = NULL;
+    fopen_s(&fp, filename, "w");
+    if (fp == NULL) {
+        std::cerr << "profiler: could not write " << filename << std::endl;
+        return false;
+    }
+
+    // one track per thread (the first to record is usually the main
+    // thread), and one for the GPU
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                "\"args\":{\"name\":\"asst5\"}}");
+    long written = 0;
+    int numRings = ringCount.load() < MAX_RINGS ? ringCount.load() : MAX_RINGS;
+    for (int r = 0; r < numRings; r++) {
+        const ProfileRing* ring = rings[r];
+        if (ring == NULL) continue;
+        char track[32];
+        if (ring == gpuRing) snprintf(track, sizeof(track), "GPU");
+        else snprintf(track, sizeof(track), "thread %d", ring->id);
+        fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                    "\"args\":{\"name\":\"%s\"}}", ring->id, track);
+
+        uint64_t count = ring->count.load(std::memory_order_acquire);
+        uint64_t first = count > RING_EVENTS ? count - RING_EVENTS : 0;
+        for (uint64_t i = first; i < count; i++) {
+            const ProfileEvent& e = ring->events[i & (RING_EVENTS - 1)];
+            fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                        "\"ts\":%.3f,\"dur\":%.3f}",
+                    e.name, ring->id, e.start / 1000.0,
+                    (e.end > e.start ? e.end - e.start : 0) / 1000.0);
+            written++;
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    bool ok = fclose(fp) == 0;
+    std::cout << "profiler: " << written << " zones from " << numRings
+              << " tracks written to " << filename << std::endl;
+    return ok;
+}
+
+#else // profiler not built in
+
+bool profileWriteTrace(const char*) {
+    std::cerr << "profiler: not built in (configure with -DASST5_PROFILER=ON)"
+              << std::endl;
+    return false;
+}
+
+#endif
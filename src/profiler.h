@@ -0,0 +1,78 @@
+/*
+ * Profiler: records where frame time goes, on the CPU (every thread) and
+ * on the GPU, for viewing as a timeline in Chrome's about:tracing or in
+ * Perfetto.
+ *
+ * Code marks a zone by putting PROFILE_ZONE("name") at the top of a
+ * block: the zone runs from there to the end of the block.
+ * PROFILE_GPU_ZONE("name") does the same for the GPU work issued in the
+ * block, timed with OpenGL timestamp queries.  The name must be a string
+ * literal, or live as long as the program.  PROFILE_FRAME() goes once per
+ * frame, after the last GPU zone: it collects the GPU times that have
+ * come in.
+ *
+ * Each thread writes its zones to a ring buffer of its own, with no locks
+ * and no allocation, so a zone costs two clock reads and a store.  Each
+ * ring keeps its thread's latest 65536 zones.
+ * profileWriteTrace() writes what they hold as Chrome trace-event JSON.
+ * It is best called between frames, with no job running, because a
+ * thread writing meanwhile can overwrite an event as it is read.
+ *
+ * All of this exists only in builds with ASST5_PROFILER defined; in other
+ * builds the macros expand to nothing.
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <stdint.h>
+
+// write the trace to 'filename'; returns false (after printing why) if
+// the file cannot be written, or the profiler is not built in
+bool profileWriteTrace(const char* filename);
+
+#ifdef ASST5_PROFILER
+
+// nanoseconds since the profiler started
+uint64_t profileNow(void);
+
+// record a CPU zone on this thread
+void profileRecord(const char* name, uint64_t start, uint64_t end);
+
+// start and end a GPU zone; the number returned by the one goes to the other
+int profileGpuBegin(const char* name);
+void profileGpuEnd(int zone);
+
+// collect GPU times that are ready
+void profileFrame(void);
+
+class ProfileZone {
+    const char* _name;
+    uint64_t _start;
+public:
+    explicit ProfileZone(const char* name): _name(name), _start(profileNow()) { }
+    ~ProfileZone() { profileRecord(_name, _start, profileNow()); }
+};
+
+class GpuProfileZone {
+    int _zone;
+public:
+    explicit GpuProfileZone(const char* name): _zone(profileGpuBegin(name)) { }
+    ~GpuProfileZone() { profileGpuEnd(_zone); }
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_GPU_ZONE(name) GpuProfileZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#define PROFILE_FRAME() profileFrame()
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_GPU_ZONE(name)
+#define PROFILE_FRAME()
+
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Quaternion code; unit quaternions represent rotations.
+ */
+
+#include "quat.h"
+
+quat normalize(const quat& q) {
+    GLfloat len = std::sqrt(dot(q, q));
+    if (len < DivideByZeroTolerance) return quat();
+    return q * (1 / len);
+}
+
+quat axisAngle(const vec3& axis, GLfloat degrees) {
+    GLfloat len = std::sqrt(dot(axis, axis));
+    if (len < DivideByZeroTolerance) return quat();
+    GLfloat half = GLfloat(DegreesToRadians * degrees / 2);
+    GLfloat s = std::sin(half) / len;
+    return quat(std::cos(half), axis.x * s, axis.y * s, axis.z * s);
+}
+
+quat eulerXYZ(GLfloat ax, GLfloat ay, GLfloat az) {
+    return axisAngle(vec3(1, 0, 0), ax) * axisAngle(vec3(0, 1, 0), ay) *
+           axisAngle(vec3(0, 0, 1), az);
+}
+
+quat integrate(const quat& q, const vec3& angularVelocity, GLfloat dt) {
+    // a constant angular velocity is a rotation about its own axis, by its
+    // length times the time: exact, and no worse to compute than a step of
+    // dq/dt = w q / 2
+    GLfloat rate = std::sqrt(dot(angularVelocity, angularVelocity));
+    if (rate * dt == 0) return q;
+    return normalize(axisAngle(angularVelocity, rate * dt) * q);
+}
+
+quat slerp(const quat& p, const quat& q, GLfloat t) {
+    // q and -q are the same rotation; take whichever is nearer p
+    GLfloat cosAngle = dot(p, q);
+    quat target = q;
+    if (cosAngle < 0) {
+        cosAngle = -cosAngle;
+        target = -q;
+    }
+
+    // nearly the same rotation: the arc is a line, and sin(angle) ~ 0
+    if (cosAngle > 0.9995f) return nlerp(p, target, t);
+
+    GLfloat angle = std::acos(cosAngle);
+    GLfloat s = 1 / std::sin(angle);
+    return p * (std::sin((1 - t) * angle) * s) + target * (std::sin(t * angle) * s);
+}
+
+quat nlerp(const quat& p, const quat& q, GLfloat t) {
+    quat target = dot(p, q) < 0 ? -q : q;
+    return normalize(p * (1 - t) + target * t);
+}
+
+vec3 rotate(const quat& q, const vec3& v) {
+    // v + 2w(u x v) + 2u x (u x v), u being q's vector part
+    vec3 u(q.x, q.y, q.z);
+    vec3 t = cross(u, v) * 2;
+    return v + t * q.w + cross(u, t);
+}
+
+quat rotationBetween(const vec3& from, const vec3& to) {
+    GLfloat cosAngle = dot(from, to);
+    if (cosAngle < -0.99999f) {
+        // opposite: half a turn about any axis at right angles to 'from'
+        vec3 axis = cross(vec3(1, 0, 0), from);
+        if (dot(axis, axis) < 1e-6f) axis = cross(vec3(0, 1, 0), from);
+        return axisAngle(axis, 180);
+    }
+    // (1 + cos a, sin a * axis) is the half-angle quaternion, unnormalized
+    vec3 axis = cross(from, to);
+    return normalize(quat(1 + cosAngle, axis.x, axis.y, axis.z));
+}
+
+mat4 toMat4(const quat& q) {
+    GLfloat xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    GLfloat xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    GLfloat wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    mat4 m;
+    m[0][0] = 1 - 2 * (yy + zz);
+    m[0][1] = 2 * (xy - wz);
+    m[0][2] = 2 * (xz + wy);
+    m[1][0] = 2 * (xy + wz);
+    m[1][1] = 1 - 2 * (xx + zz);
+    m[1][2] = 2 * (yz - wx);
+    m[2][0] = 2 * (xz - wy);
+    m[2][1] = 2 * (yz + wx);
+    m[2][2] = 1 - 2 * (xx + yy);
+    return m;
+}
+
+std::ostream& operator << (std::ostream& os, const quat& q) {
+    return os << "( " << q.w << ", " << q.x << ", " << q.y << ", " << q.z << " )";
+}
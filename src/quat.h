@@ -0,0 +1,79 @@
+/*
+ * Quaternion code; unit quaternions represent rotations.
+ *
+ * A quaternion q = (w, x, y, z) with w = cos(a/2) and (x, y, z) =
+ * sin(a/2) times a unit axis rotates by a about that axis.  Products
+ * compose rotations as matrices do: (p * q) applies q first, then p.
+ * Angles are in degrees, as with RotateX() and friends in mat.h.
+ */
+
+#ifndef __QUAT_H__
+#define __QUAT_H__
+
+#include "vec.h"
+#include "mat.h"
+
+struct quat {
+
+    // instance variables: the scalar part, then the vector part
+    GLfloat w;
+    GLfloat x, y, z;
+
+    // constructors: the identity (no rotation), or the given components
+    quat(): w(1), x(0), y(0), z(0) { }
+    quat(GLfloat w, GLfloat x, GLfloat y, GLfloat z): w(w), x(x), y(y), z(z) { }
+
+    // the Hamilton product: this rotation after q's
+    quat operator * (const quat& q) const {
+        return quat(w * q.w - x * q.x - y * q.y - z * q.z,
+                    w * q.x + x * q.w + y * q.z - z * q.y,
+                    w * q.y - x * q.z + y * q.w + z * q.x,
+                    w * q.z + x * q.y - y * q.x + z * q.w);
+    }
+
+    quat operator * (GLfloat s) const { return quat(w * s, x * s, y * s, z * s); }
+    quat operator + (const quat& q) const { return quat(w + q.w, x + q.x, y + q.y, z + q.z); }
+    quat operator - () const { return quat(-w, -x, -y, -z); }
+};
+
+inline GLfloat dot(const quat& p, const quat& q) {
+    return p.w * q.w + p.x * q.x + p.y * q.y + p.z * q.z;
+}
+
+// the inverse rotation (for a unit quaternion)
+inline quat conjugate(const quat& q) {
+    return quat(q.w, -q.x, -q.y, -q.z);
+}
+
+// scale to unit length, undoing the drift of repeated products; a zero
+// quaternion becomes the identity
+quat normalize(const quat& q);
+
+// rotation by 'degrees' about 'axis' (which need not be unit length)
+quat axisAngle(const vec3& axis, GLfloat degrees);
+
+// the same rotation as RotateX(ax) * RotateY(ay) * RotateZ(az)
+quat eulerXYZ(GLfloat ax, GLfloat ay, GLfloat az);
+
+// advance an orientation by an angular velocity (degrees per second about
+// each of the world's axes) over dt seconds
+quat integrate(const quat& q, const vec3& angularVelocity, GLfloat dt);
+
+// interpolate between two rotations, t from 0 (p) to 1 (q), along the
+// shorter way round: slerp turns at a constant rate; nlerp is cheaper
+// (no trig) and only slightly uneven for nearby rotations
+quat slerp(const quat& p, const quat& q, GLfloat t);
+quat nlerp(const quat& p, const quat& q, GLfloat t);
+
+// rotate a vector
+vec3 rotate(const quat& q, const vec3& v);
+
+// the smallest rotation taking one unit vector to another
+quat rotationBetween(const vec3& from, const vec3& to);
+
+// the rotation matrix for a unit quaternion
+mat4 toMat4(const quat& q);
+
+std::ostream& operator << (std::ostream& os, const quat& q);
+
+#endif
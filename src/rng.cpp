@@ -0,0 +1,212 @@
+/*
+ * Random-number code: small, fast, seedable generators.
+ */
+
+#include "rng.h"
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define RNG_SSE 1
+#endif
+
+static inline uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint32_t rotl32(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// SplitMix64: spreads a seed's bits over a whole state, as the xoshiro
+// authors recommend
+static uint64_t splitMix(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+Rng::Rng(uint64_t seed, uint64_t stream) {
+    this->seed(seed, stream);
+}
+
+void Rng::seed(uint64_t seed, uint64_t stream) {
+    // the stream number is hashed into the seed, so nearby streams of
+    // nearby seeds still start far apart
+    uint64_t mix = stream;
+    uint64_t x = seed ^ splitMix(mix);
+    for (int i = 0; i < 4; i++) _s[i] = splitMix(x);
+    if ((_s[0] | _s[1] | _s[2] | _s[3]) == 0) _s[0] = 1; // the one bad state
+    _lanesSeeded = false;
+}
+
+uint64_t Rng::next(void) {
+    uint64_t result = rotl64(_s[1] * 5, 7) * 9;
+    uint64_t t = _s[1] << 17;
+    _s[2] ^= _s[0];
+    _s[3] ^= _s[1];
+    _s[1] ^= _s[2];
+    _s[0] ^= _s[3];
+    _s[2] ^= t;
+    _s[3] = rotl64(_s[3], 45);
+    return result;
+}
+
+uint32_t Rng::below(uint32_t bound) {
+    if (bound == 0) return 0;
+    // the high half of a 32x32-bit product is in [0, bound); values whose
+    // low half falls below 2^32 mod bound would make some results more
+    // likely than others, so they are drawn again
+    uint64_t m = (uint64_t)next32() * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            m = (uint64_t)next32() * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+int Rng::range(int lo, int hi) {
+    if (hi <= lo) return lo;
+    return lo + (int)below((uint32_t)(hi - lo) + 1);
+}
+
+void Rng::jump(void) {
+    static const uint64_t JUMP[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & (1ULL << b)) {
+                for (int k = 0; k < 4; k++) s[k] ^= _s[k];
+            }
+            next();
+        }
+    }
+    for (int k = 0; k < 4; k++) _s[k] = s[k];
+    _lanesSeeded = false;
+}
+
+//----------------------------------------------------------------------------
+//  Bulk generation: four xoshiro128++ generators side by side
+//----------------------------------------------------------------------------
+
+#ifdef RNG_SSE
+// rotate each 32-bit lane left by k
+static inline __m128i rotlLanes(__m128i x, int k) {
+    return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k));
+}
+#endif
+
+void Rng::fill(uint32_t* out, size_t n) {
+    if (!_lanesSeeded) {
+        // seeded from the main generator; a lane must not be all zero
+        for (int i = 0; i < 16; i += 2) {
+            uint64_t x = next();
+            _lanes[i] = (uint32_t)x;
+            _lanes[i + 1] = (uint32_t)(x >> 32);
+        }
+        for (int l = 0; l < 4; l++) {
+            if ((_lanes[l] | _lanes[4 + l] | _lanes[8 + l] | _lanes[12 + l]) == 0) {
+                _lanes[l] = 1;
+            }
+        }
+        _lanesSeeded = true;
+    }
+
+    size_t i = 0;
+    uint32_t last[4];
+#ifdef RNG_SSE
+    __m128i s0 = _mm_loadu_si128((const __m128i*)&_lanes[0]);
+    __m128i s1 = _mm_loadu_si128((const __m128i*)&_lanes[4]);
+    __m128i s2 = _mm_loadu_si128((const __m128i*)&_lanes[8]);
+    __m128i s3 = _mm_loadu_si128((const __m128i*)&_lanes[12]);
+    while (i < n) {
+        __m128i result = _mm_add_epi32(rotlLanes(_mm_add_epi32(s0, s3), 7), s0);
+        __m128i t = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = rotlLanes(s3, 11);
+        if (n - i >= 4) {
+            _mm_storeu_si128((__m128i*)(out + i), result);
+            i += 4;
+        }
+        else {
+            _mm_storeu_si128((__m128i*)last, result);
+            for (int l = 0; i < n; l++) out[i++] = last[l];
+        }
+    }
+    _mm_storeu_si128((__m128i*)&_lanes[0], s0);
+    _mm_storeu_si128((__m128i*)&_lanes[4], s1);
+    _mm_storeu_si128((__m128i*)&_lanes[8], s2);
+    _mm_storeu_si128((__m128i*)&_lanes[12], s3);
+#else
+    uint32_t* s0 = &_lanes[0];
+    uint32_t* s1 = &_lanes[4];
+    uint32_t* s2 = &_lanes[8];
+    uint32_t* s3 = &_lanes[12];
+    while (i < n) {
+        for (int l = 0; l < 4; l++) {
+            last[l] = rotl32(s0[l] + s3[l], 7) + s0[l];
+            uint32_t t = s1[l] << 9;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = rotl32(s3[l], 11);
+        }
+        for (int l = 0; l < 4 && i < n; l++) out[i++] = last[l];
+    }
+#endif
+}
+
+void Rng::fillBelow(uint32_t* out, size_t n, uint32_t bound) {
+    if (bound == 0) {
+        for (size_t i = 0; i < n; i++) out[i] = 0;
+        return;
+    }
+    // as below(), with the rare values that must be drawn again drawn
+    // from the main generator
+    fill(out, n);
+    uint32_t threshold = (0u - bound) % bound;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t m = (uint64_t)out[i] * bound;
+        out[i] = (uint32_t)m < threshold ? below(bound) : (uint32_t)(m >> 32);
+    }
+}
+
+void Rng::fillUniform(float* out, size_t n) {
+    uint32_t bits[256];
+    for (size_t i = 0; i < n; ) {
+        size_t count = n - i < 256 ? n - i : 256;
+        fill(bits, count);
+        for (size_t k = 0; k < count; k++) {
+            out[i + k] = (bits[k] >> 8) * (1.0f / 16777216.0f);
+        }
+        i += count;
+    }
+}
+
+//----------------------------------------------------------------------------
+
+static std::atomic<uint64_t> threadSeed(0);
+static std::atomic<uint64_t> threadCount(0);
+
+Rng& threadRng(void) {
+    static thread_local Rng rng(threadSeed.load(), threadCount++);
+    return rng;
+}
+
+void rngSeedThreads(uint64_t seed) {
+    threadSeed = seed;
+}
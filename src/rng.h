@@ -0,0 +1,73 @@
+/*
+ * Random-number code: small, fast, seedable generators.
+ *
+ * Rng is xoshiro256** (Blackman and Vigna): 256 bits of state, 64-bit
+ * outputs, and a period of 2^256 - 1.  A generator is seeded with a seed
+ * and a stream number; different streams of one seed (one per thread, or
+ * per table in a simulation) are independent for all practical purposes,
+ * and the same seed and stream always give the same numbers.  Nothing is
+ * shared between generators, so each thread can own its own without
+ * locking.
+ *
+ * Bounded integers come from Lemire's multiply-and-reject method, so every
+ * value is equally likely (unlike rand() % n), usually with no division.
+ *
+ * fill() produces many 32-bit values at once from four interleaved
+ * xoshiro128++ generators, run side by side in SSE2 registers where
+ * available; without SSE2 the same four run one after another, so the
+ * values are the same either way.
+ */
+
+#ifndef __RNG_H__
+#define __RNG_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Rng {
+    uint64_t _s[4];      // xoshiro256** state
+    uint32_t _lanes[16]; // fill()'s xoshiro128++ states: word w of lane l
+                         // is _lanes[4 * w + l]
+    bool _lanesSeeded;
+
+public:
+    // constructor: stream 'stream' of the given seed
+    explicit Rng(uint64_t seed = 0, uint64_t stream = 0);
+
+    // start over, as a new generator would
+    void seed(uint64_t seed, uint64_t stream = 0);
+
+    // 64 (or 32) random bits
+    uint64_t next(void);
+    uint32_t next32(void) { return (uint32_t)(next() >> 32); }
+
+    // a number from 0 to bound-1, each equally likely; 0 if bound is 0
+    uint32_t below(uint32_t bound);
+
+    // an integer from lo to hi inclusive, each equally likely
+    int range(int lo, int hi);
+
+    // a number in [0, 1)
+    double uniform(void) { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    float uniformf(void) { return (next32() >> 8) * (1.0f / 16777216.0f); }
+
+    // skip ahead 2^128 numbers: gives a sequence that cannot overlap this
+    // one for that long
+    void jump(void);
+
+    // fill out[0..n-1] with random 32-bit values, or with numbers from 0
+    // to bound-1 (each equally likely), or in [0, 1)
+    void fill(uint32_t* out, size_t n);
+    void fillBelow(uint32_t* out, size_t n, uint32_t bound);
+    void fillUniform(float* out, size_t n);
+};
+
+// this thread's generator, for work that needs no particular sequence;
+// each thread's is a different stream of the seed given to rngSeedThreads
+// (default 0), numbered in the order threads first ask for one
+Rng& threadRng(void);
+
+// the seed for threadRng() generators created from now on
+void rngSeedThreads(uint64_t seed);
+
+#endif
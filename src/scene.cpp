@@ -0,0 +1,763 @@
+//
+//  Scene code for the Pig dice game: the geometry, the shaders, and the
+//  drawing of one frame from a snapshot of the game state.
+//
+//  Light and material properties are sent to the shader as uniform
+//    variables.  Vertex positions and normals are attribute variables.
+//  Shininess comes into play, so the side of a cube will not necessarily
+//    appear as a uniform color.
+
+#include "cs432.h"
+#include <cstddef>
+#include <cassert>
+#include <stdlib.h>
+#include <string>
+#include "vec.h"
+#include "mat.h"
+#include "picking.h"
+#include "characters.h"
+#include "cube.h"
+#include "streamBuffer.h"
+#include "glState.h"
+#include "jobs.h"
+#include "scene.h"
+#include "frameClock.h"
+#include "profiler.h"
+
+// typedefs to make code more readable
+typedef vec4  color4;
+typedef vec4  point4;
+
+// the objects in our scene: where each character's and the (instanced)
+// cube's vertices are in the vertex buffer.  Characters come in several
+// levels of detail, each with half the arc divisions of the one before.
+static LodSet charLods[256];
+static ObjRef cubeInfo;
+static const int CHAR_LOD_LEVELS = 3;
+static const GLfloat CHAR_FULL_DETAIL_SIZE = 30; // pixels across
+
+// the vertices of all our objects, as generated (and sent to the GPU)
+static Mesh sceneMesh;
+
+// ome color definitions
+static color4 RED(1.0, 0.0, 0.0, 1.0);
+
+// the dice are either drawn as instances of one cube, each instance with
+// its own model-view matrix, color and pick color, or (without instancing)
+// regenerated each frame in their current colors and streamed to the GPU;
+// everything else is generated once, at startup
+static color4 diceColors[NUM_DICE] = { RED, RED, RED, RED, RED };
+static const GLfloat DICE_SHININESS = 30;
+static StreamBuffer diceStream;
+
+// one dice's per-instance attributes.  The matrix is stored transposed,
+// i.e., column by column, as a mat4 attribute is read.
+struct DiceInstance {
+    mat4 modelView;
+    vec4 color;
+    vec4 pickColor;
+};
+
+// the most dice in one instanced draw call
+static const int MAX_INSTANCES = 1024;
+static StreamBuffer instanceStream;
+static bool instancing, instancingAvailable;
+
+// the per-instance attributes' locations, and the uniform that selects them
+static GLint vInstanceModelView, vInstanceColor, vInstancePick;
+static GLint Instanced;
+
+// vertex array objects for the static vertices, the streamed ones, and the
+// static ones with per-instance attributes
+static GLuint staticVao, streamVao, instancedVao;
+
+// Model-view, model-view-start and projection matrices uniform location
+static GLint  ModelView, ModelViewStart, Projection;
+
+// the per-frame constants, laid out as the shaders' std140 Frame block:
+// the matrices column by column, then the light
+struct FrameConstants {
+    mat4 projection;
+    mat4 modelViewStart;
+    vec4 lightPosition;
+    vec4 lightAmbient, lightDiffuse, lightSpecular;
+};
+
+// where the driver has uniform buffers, the per-frame constants are
+// written once per frame into a ring of them, bound at FRAME_BINDING;
+// otherwise they are separate uniforms
+static const GLuint FRAME_BINDING = 0;
+static StreamBuffer frameStream;
+static bool frameBlock;
+
+// the draw calls and triangles of the last frame submitted
+static DrawStats drawStats = { 0, 0 };
+
+// the light's intensities
+static const color4 LIGHT_AMBIENT(0, 0, 0, 1.0);
+static const color4 LIGHT_DIFFUSE(1, 1, 1, 1.0);
+static const color4 LIGHT_SPECULAR(0.4, 0.4, 0.4, 1.0);
+
+// the projection, whose frustum we cull against
+static mat4 projection;
+
+// the viewport's height, in pixels, for judging how large objects appear
+static int viewportHeight = 1;
+
+// each object's current level of detail, by its place in the draw list as
+// built (see selectLevels)
+static std::vector<int> lodLevels;
+
+// whether to cull, and the culling pass's working storage (kept between
+// frames, like the draw list)
+static bool culling = true;
+static SphereBatch cullBatch;
+static std::vector<unsigned char> cullVisible;
+
+// the draw list for the current frame; kept between frames so that its
+// storage is reused
+static std::vector<DrawItem> frameItems;
+
+//----------------------------------------------------------------------------
+
+// the GPU light ID, this allows us to change the position of the light during execution
+static int lightId;
+
+// the light's position, which wanders as the game goes on
+static vec4 lightPosition(GLfloat angle) {
+    GLfloat lightX = sin(angle * 0.023);
+    GLfloat lightY = sin(angle * 0.031);
+    GLfloat lightZ = sin(angle * 0.037);
+    return vec4(lightX, lightY, lightZ, 0.0);
+}
+
+// send this frame's camera and light to the GPU: one write to the frame's
+// uniform buffer, or (without uniform buffers) the uniforms that changed
+static void updateFrameConstants(GLfloat lightAngle, const mat4& camera) {
+    if (!frameBlock) {
+        stateUniform4fv(lightId, lightPosition(lightAngle));
+        stateUniformMatrix4fv(ModelViewStart, transpose(camera));
+        return;
+    }
+    FrameConstants* frame = (FrameConstants*)frameStream.begin();
+    frame->projection = transpose(projection);
+    frame->modelViewStart = transpose(camera);
+    frame->lightPosition = lightPosition(lightAngle);
+    frame->lightAmbient = LIGHT_AMBIENT;
+    frame->lightDiffuse = LIGHT_DIFFUSE;
+    frame->lightSpecular = LIGHT_SPECULAR;
+    GLintptr offset = frameStream.end(sizeof(FrameConstants));
+    stateBindBufferRange(GL_UNIFORM_BUFFER, FRAME_BINDING, frameStream.buffer(),
+                      offset, sizeof(FrameConstants));
+}
+//----------------------------------------------------------------------------
+
+// the pick-id each dice reports
+static const int dicePickIds[NUM_DICE] = { 1, 2, 3, 4, 5 };
+
+// add one object to the draw list, placed by 'model' relative to the
+// scoreboard; its model-view matrix is completed later, in prepareItems
+static void addItem(std::vector<DrawItem>& items, const mat4& model,
+                    int start, int count, const Bounds& bounds,
+                    int pickId = 0, int dice = -1, const LodSet* lod = NULL) {
+    DrawItem item;
+    item.modelView = model;
+    item.start = start;
+    item.count = count;
+    item.pickId = pickId;
+    item.dice = dice;
+    item.bounds = vec4(bounds.center, bounds.radius);
+    item.lod = lod;
+    item.lodSlot = (int)items.size();
+    items.push_back(item);
+}
+
+// add a character, placed at (x, y) in the plane of the scoreboard
+static void addCharacter(std::vector<DrawItem>& items,
+                         char c, GLfloat x, GLfloat y, int pickId = 0) {
+    const LodSet& lods = charLods[(unsigned char)c];
+    const ObjRef& ref = lods.level(0);
+    addItem(items, Translate(x, y, -2), ref.getStartIdx(), ref.getCount(),
+            ref.getBounds(), pickId, -1, &lods);
+}
+
+// add a string, one character per given x-position
+static void addText(std::vector<DrawItem>& items,
+                    const char* text, const GLfloat* xs, GLfloat y, int pickId = 0) {
+    for (int i = 0; text[i] != '\0'; i++) {
+        addCharacter(items, text[i], xs[i], y, pickId);
+    }
+}
+
+// add a score of up to three digits; the hundreds and tens digits are only
+// shown when they are needed
+static void addScore(std::vector<DrawItem>& items, int score,
+                     GLfloat hundredsX, GLfloat tensX, GLfloat onesX, GLfloat y) {
+    if (score >= 100) {
+        addCharacter(items, '0' + (score / 100) % 10, hundredsX, y);
+    }
+    if (score > 9) {
+        addCharacter(items, '0' + (score / 10) % 10, tensX, y);
+    }
+    addCharacter(items, '0' + (score % 10), onesX, y);
+}
+
+// the most objects one job prepares; lists shorter than this are prepared
+// on the calling thread
+static const int PREPARE_GRAIN = 64;
+
+// finish the model-view matrices, then drop the objects whose bounding
+// spheres are entirely outside the view frustum, and choose a level of
+// detail for the rest.  Each object is independent of the others, so this
+// is shared among the job system's threads.
+//
+// The frustum is the projection's, in eye coordinates, so each sphere is
+// taken there by its object's model-view matrix (which includes the
+// camera); its radius grows by the matrix's largest scale factor.
+//
+// The previous level of detail, which makes the choice sticky, is found by
+// the object's place in the list as built; that only changes when the
+// layout does (e.g., a score gains a digit), and then the object's level
+// still ends up within the hysteresis band of its size.
+static void prepareItems(std::vector<DrawItem>& items, const mat4& base,
+                         CullStats* stats) {
+    int n = (int)items.size();
+    ViewFrustum frustum = frustumFromMatrix(projection);
+    cullBatch.resize(n);
+    cullVisible.resize(n);
+    if ((int)lodLevels.size() < n) lodLevels.resize(n, -1);
+
+    parallelFor(n, PREPARE_GRAIN, [&](int begin, int end) {
+        PROFILE_ZONE("prepare items");
+        for (int i = begin; i < end; i++) {
+            DrawItem& item = items[i];
+            item.modelView = base * item.modelView;
+            const vec4& b = item.bounds;
+            vec4 center = item.modelView * vec4(b.x, b.y, b.z, 1.0);
+            cullBatch.set(i, vec3(center.x, center.y, center.z),
+                          b.w * largestScale(item.modelView));
+        }
+        if (culling) {
+            cullSpheres(frustum, cullBatch, begin, end, &cullVisible[0]);
+        }
+        else {
+            for (int i = begin; i < end; i++) cullVisible[i] = 1;
+        }
+
+        // draw what is left in no more detail than can be seen, with its
+        // matrix ready for the GPU
+        for (int i = begin; i < end; i++) {
+            DrawItem& item = items[i];
+            if (!cullVisible[i]) continue;
+            item.gpuModelView = transpose(item.modelView);
+            if (item.lod == NULL) continue;
+            GLfloat size = projectedSize(item.bounds, item.modelView, projection,
+                                         viewportHeight);
+            int level = item.lod->select(size, lodLevels[item.lodSlot]);
+            lodLevels[item.lodSlot] = level;
+            const ObjRef& ref = item.lod->level(level);
+            item.start = ref.getStartIdx();
+            item.count = ref.getCount();
+        }
+    });
+
+    // keep the visible ones, in order
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        if (cullVisible[i]) items[kept++] = items[i];
+    }
+    if (stats != NULL) {
+        stats->tested += n;
+        stats->culled += n - kept;
+    }
+    items.resize(kept);
+}
+
+bool sceneSetCulling(bool on) {
+    culling = on;
+    return culling;
+}
+
+// build the list of objects to draw for one frame; pure matrix math, no GL.
+// The layout below places each object relative to the scoreboard, and
+// prepareItems does the per-object work.
+void sceneBuild(const GameSnapshot& snap, const mat4& camera,
+                std::vector<DrawItem>& items, CullStats* stats) {
+    PROFILE_ZONE("build");
+    items.clear();
+
+    // set up the initial model-view, based on the current camera position/orientation
+    mat4 base = camera * Scale(0.2, 0.2, 0.2);
+
+    // the dice, where the physics has them on the table
+    for (int i = 0; i < NUM_DICE; i++) {
+        addItem(items, Translate(snap.dicePosition[i]) * toMat4(snap.diceOrientation[i]),
+                i * cubeVertexCount(), cubeVertexCount(), cubeInfo.getBounds(),
+                dicePickIds[i], i);
+    }
+
+    // my score, with an underline marking my turn
+    static const GLfloat youXs[] = { -8, -7, -5.5, -4.5 };
+    addText(items, "You:", youXs, 12);
+    if (snap.myTurn) addCharacter(items, '_', -8, 11);
+    addScore(items, snap.myScore, -3.2, -2.8, -1.5, 12);
+
+    // the win message, which (like "Hold") picks as code 2
+    if (snap.myScore >= WINNING_SCORE) {
+        static const GLfloat winXs[] = { -8, -7, -5.5, -3, -2, -1, 0 };
+        addText(items, "YouWin!", winXs, 0, 2);
+    }
+
+    // the "Hold" button, and what holding would bank
+    static const GLfloat holdXs[] = { -8, -6, -5, -4 };
+    addText(items, "Hold", holdXs, 8, 2);
+    if (snap.turnTotal > 0) addScore(items, snap.turnTotal, -2.2, -1.8, -0.5, 8);
+
+    // the AI's score, with an underline marking its turn
+    static const GLfloat aiXs[] = { 1.5, 3, 4 };
+    addText(items, "AI:", aiXs, 12);
+    if (!snap.myTurn) addCharacter(items, '_', 1.5, 11);
+    addScore(items, snap.AIScore, 6.0, 6.5, 8.0, 12);
+    if (snap.AIScore >= WINNING_SCORE) {
+        static const GLfloat aiWinXs[] = { 1.5, 3, 5.5, 6.5, 7.5, 8.5 };
+        addText(items, "AIWin!", aiWinXs, 4);
+    }
+
+    prepareItems(items, base, stats);
+}
+
+void sceneSetDiceColor(int die, const vec4& color) {
+    if (die >= 0 && die < NUM_DICE) diceColors[die] = color;
+}
+
+// generate this frame's dice straight into the streaming buffer, one cube
+// per dice; returns the index of the first vertex
+static int streamDice(void) {
+    PROFILE_ZONE("generate dice");
+    int numVertices = NUM_DICE * cubeVertexCount();
+    Mesh mesh((Vertex*)diceStream.begin(), numVertices);
+    for (int i = 0; i < NUM_DICE; i++) {
+        genCube(mesh, diceColors[i], DICE_SHININESS);
+    }
+    return (int)(diceStream.end(mesh.size() * sizeof(Vertex)) / sizeof(Vertex));
+}
+
+bool sceneSetInstancing(bool on) {
+    instancing = on && instancingAvailable;
+    return instancing;
+}
+
+// point the per-instance attributes at the instances at 'offset' in the
+// instance buffer; the instanced vertex array object must be bound
+static void setInstanceAttributes(GLintptr offset) {
+    stateBindBuffer(GL_ARRAY_BUFFER, instanceStream.buffer());
+    for (int c = 0; c < 4; c++) {
+        glVertexAttribPointer(vInstanceModelView + c, 4, GL_FLOAT, GL_FALSE,
+            sizeof(DiceInstance),
+            BUFFER_OFFSET(offset + offsetof(DiceInstance, modelView) + c * sizeof(vec4)));
+    }
+    if (vInstanceColor >= 0) {
+        glVertexAttribPointer(vInstanceColor, 4, GL_FLOAT, GL_FALSE, sizeof(DiceInstance),
+            BUFFER_OFFSET(offset + offsetof(DiceInstance, color)));
+    }
+    if (vInstancePick >= 0) {
+        glVertexAttribPointer(vInstancePick, 4, GL_FLOAT, GL_FALSE, sizeof(DiceInstance),
+            BUFFER_OFFSET(offset + offsetof(DiceInstance, pickColor)));
+    }
+}
+
+// draw all of the dice in the list as instances of the cube: one draw
+// call, or one per MAX_INSTANCES dice
+static void drawDiceInstanced(const std::vector<DrawItem>& items) {
+    stateBindVertexArray(instancedVao);
+    stateUniform1i(Instanced, 1);
+    size_t next = 0;
+    for (;;) {
+        DiceInstance* instances = (DiceInstance*)instanceStream.begin();
+        int n = 0;
+        for (; next < items.size() && n < MAX_INSTANCES; next++) {
+            const DrawItem& item = items[next];
+            if (item.dice < 0) continue;
+            DiceInstance& instance = instances[n++];
+            instance.modelView = item.gpuModelView;
+            instance.color = diceColors[item.dice];
+            instance.pickColor = pickColorFor(item.pickId);
+        }
+        if (n == 0) break;
+
+        setInstanceAttributes(instanceStream.end(n * sizeof(DiceInstance)));
+        glDrawArraysInstanced(GL_TRIANGLES, cubeInfo.getStartIdx(), cubeInfo.getCount(), n);
+        instanceStream.fence();
+        drawStats.drawCalls++;
+        drawStats.triangles += (long)n * (cubeInfo.getCount() / 3);
+    }
+    stateUniform1i(Instanced, 0);
+    stateBindVertexArray(staticVao);
+}
+
+// send the per-frame values and then each object in the list to the GPU;
+// if 'times' is given, the time spent in uniform uploads and in draw calls
+// is added to it (which costs a clock read around every call)
+void sceneSubmit(const GameSnapshot& snap, const mat4& camera,
+                 const std::vector<DrawItem>& items, SubmitTimes* times) {
+    PROFILE_ZONE("submit");
+    double t0 = times != NULL ? clockNow() : 0;
+    drawStats.drawCalls = 0;
+    drawStats.triangles = 0;
+
+    // set all to background color
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // the light (based on the light-rotation information) and the camera
+    updateFrameConstants(snap.lightAngle, camera);
+
+    // and this frame's dynamic geometry
+    int streamFirst = instancing ? 0 : streamDice();
+    bool streaming = false;
+
+    // when picking, objects that cannot be picked draw as background
+    clearPickId();
+
+    double t1 = times != NULL ? clockNow() : 0;
+    if (times != NULL) times->upload += t1 - t0;
+
+    // the dice, all in one go
+    if (instancing) {
+        drawDiceInstanced(items);
+        double t2 = times != NULL ? clockNow() : 0;
+        if (times != NULL) times->draw += t2 - t1;
+        t1 = t2;
+    }
+
+    for (size_t i = 0; i < items.size(); i++) {
+        const DrawItem& item = items[i];
+        if (instancing && item.dice >= 0) continue;
+        stateUniformMatrix4fv(ModelView, item.gpuModelView);
+        if (item.pickId != 0) {
+            setPickId(item.pickId); // set pick-id, in case we're picking
+        }
+
+        double t2 = times != NULL ? clockNow() : 0;
+        if ((item.dice >= 0) != streaming) {
+            streaming = item.dice >= 0;
+            stateBindVertexArray(streaming ? streamVao : staticVao);
+        }
+        glDrawArrays(GL_TRIANGLES, item.start + (streaming ? streamFirst : 0), item.count);
+        drawStats.drawCalls++;
+        drawStats.triangles += item.count / 3;
+        double t3 = times != NULL ? clockNow() : 0;
+
+        if (item.pickId != 0) {
+            clearPickId(); // clear pick-id
+        }
+        if (times != NULL) {
+            double t4 = clockNow();
+            times->upload += (t2 - t1) + (t4 - t3);
+            times->draw += t3 - t2;
+            t1 = t4;
+        }
+    }
+
+    // the streamed vertices and constants are in use until the GPU has
+    // drawn this frame
+    if (!instancing) diceStream.fence();
+    if (frameBlock) frameStream.fence();
+    if (streaming) stateBindVertexArray(staticVao);
+}
+
+const DrawStats& sceneDrawStats(void) {
+    return drawStats;
+}
+
+// draw one frame
+void sceneRender(const GameSnapshot& snap, const mat4& camera, CullStats* stats) {
+    sceneBuild(snap, camera, frameItems, stats);
+    sceneSubmit(snap, camera, frameItems);
+}
+
+//----------------------------------------------------------------------------
+
+// window-reshape: set the viewport and the matching projection
+void sceneResize(int width, int height)
+{
+    stateViewport(0, 0, width, height);
+
+    GLfloat aspect = GLfloat(width) / height;
+    projection = Perspective(65.0, aspect, 0.5, 100.0);
+    viewportHeight = height;
+
+    // (with a frame block, it goes with each frame's constants)
+    if (!frameBlock) stateUniformMatrix4fv(Projection, transpose(projection));
+}
+
+// point the shader's vertex attributes at the interleaved vertices in the
+// currently bound buffer, for the currently bound vertex array object
+static void setVertexAttributes(GLuint program) {
+    GLuint vPosition = glGetAttribLocation(program, "vPosition");
+    stateEnableVertexAttribArray(vPosition);
+    glVertexAttribPointer(vPosition, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+        BUFFER_OFFSET(offsetof(Vertex, point)));
+
+    GLuint vNormal = glGetAttribLocation(program, "vNormal");
+    stateEnableVertexAttribArray(vNormal);
+    glVertexAttribPointer(vNormal, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+        BUFFER_OFFSET(offsetof(Vertex, normal)));
+
+    GLuint vDiffCol = glGetAttribLocation(program, "vDiffCol");
+    stateEnableVertexAttribArray(vDiffCol);
+    glVertexAttribPointer(vDiffCol, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+        BUFFER_OFFSET(offsetof(Vertex, diffuse)));
+
+    GLuint vSpecCol = glGetAttribLocation(program, "vSpecCol");
+    stateEnableVertexAttribArray(vSpecCol);
+    glVertexAttribPointer(vSpecCol, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+        BUFFER_OFFSET(offsetof(Vertex, specular)));
+
+    GLuint vAmbCol = glGetAttribLocation(program, "vAmbCol");
+    stateEnableVertexAttribArray(vAmbCol);
+    glVertexAttribPointer(vAmbCol, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+        BUFFER_OFFSET(offsetof(Vertex, ambient)));
+}
+
+// OpenGL initialization: generate our objects, send them to the GPU and
+// set up the shaders; requires a current OpenGL context
+void sceneInit() {
+    PROFILE_ZONE("scene init");
+
+    // allocate exactly the room our objects need
+    int numVertices = cubeVertexCount();
+    for (int i = '!'; i <= '~'; i++) {
+        numVertices += characterLodsVertexCount(i, CHAR_LOD_LEVELS);
+    }
+    sceneMesh.reserve(numVertices);
+
+    // create the cube object, which the dice are instances of; its color is
+    // replaced by each instance's
+    cubeInfo = genCube(sceneMesh, RED, DICE_SHININESS);
+
+    // create characters, generating them into our mesh
+    {
+        PROFILE_ZONE("generate characters");
+        for (int i = '!'; i <= '~'; i++) {
+            charLods[i] = genCharacterLods(sceneMesh,
+                i, // character
+                RED, // color
+                0.3, // width of stroke
+                0.2, // depth (z-direction)
+                0.3, // shininess
+                CHAR_LOD_LEVELS, CHAR_FULL_DETAIL_SIZE);
+        }
+    }
+
+    assert(sceneMesh.size() == numVertices);
+
+    // the per-frame constants: one uniform block, where the driver has
+    // them, shared by both shaders.  (Preprocessor lines need newlines.)
+    frameBlock = glVersionAtLeast(3, 1) || glHasExtension("GL_ARB_uniform_buffer_object");
+    GLint alignment = 256;
+    if (frameBlock) glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    GLsizeiptr frameSize = (sizeof(FrameConstants) + alignment - 1) / alignment * alignment;
+    if (frameBlock && !frameStream.init(frameSize)) frameBlock = false;
+    std::string header = frameBlock ?
+        "#version 120\n"
+        "#extension GL_ARB_uniform_buffer_object : require\n"
+        "layout(std140) uniform Frame { "
+        "  mat4 Projection; "
+        "  mat4 ModelViewStart; "
+        "  vec4 LightPosition; "
+        "  vec4 light_ambient, light_diffuse, light_specular; "
+        "}; \n" :
+        "uniform mat4 ModelViewStart; "
+        "uniform mat4 Projection; "
+        "uniform vec4 LightPosition; "
+        "uniform vec4 light_ambient, light_diffuse, light_specular; \n";
+
+    // Create a vertex array object
+    glGenVertexArrays(1, &staticVao);
+    stateBindVertexArray(staticVao);
+
+    // Create and initialize a buffer object, holding the vertices with
+    // their attributes interleaved
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, sceneMesh.size() * sizeof(Vertex),
+        sceneMesh.data(), GL_STATIC_DRAW);
+
+    // Load shaders and use the resulting shader program
+    const GLchar* vShaderCode =
+        // all of our attributes from the arrays uploaded to the GPU
+        "attribute  vec4 vPosition; "
+        "attribute  vec3 vNormal; "
+        "attribute  vec4 vDiffCol; "
+        "attribute  vec4 vSpecCol; "
+        "attribute  vec4 vAmbCol; "
+        "attribute  float vObjShininess; "
+
+        // per-instance attributes, used when drawing instanced dice
+        "attribute  mat4 vInstanceModelView; "
+        "attribute  vec4 vInstanceColor; "
+        "attribute  vec4 vInstancePick; "
+
+        // uniform variables (besides the per-frame ones, above)
+        "uniform mat4 ModelView; "
+        "uniform vec4 LightDiffuse; "
+        "uniform vec4 LightSpecular; "
+        "uniform vec4 LightAmbient; "
+        "uniform vec4 PickColor; "
+        "uniform bool Instanced; "
+
+        // variables to send on to the fragment shader
+        "varying vec3 N,L, E, H; "
+        "varying vec4 colorAmbient, colorDiffuse, colorSpecular; "
+        "varying float shininess; "
+        "varying vec4 pickColor; "
+
+        // main vertex shader
+        "void main() "
+        "{ "
+
+        // an instance brings its own model-view matrix, color and pick color
+        "mat4 modelView = ModelView; "
+        "colorAmbient = vAmbCol; "
+        "colorDiffuse = vDiffCol; "
+        "colorSpecular = vSpecCol; "
+        "pickColor = PickColor; "
+        "if (Instanced) { "
+        "  modelView = vInstanceModelView; "
+        "  colorAmbient = colorDiffuse = colorSpecular = vInstanceColor; "
+        "  pickColor = vInstancePick; "
+        "} "
+
+        // Transform vertex  position into eye coordinates
+        "vec3 pos = (modelView * vPosition).xyz; "
+        " "
+        // compute the lighting-vectors
+        "N = normalize( modelView*vec4(vNormal, 0.0) ).xyz; "
+        "L = normalize( (ModelViewStart*LightPosition).xyz - pos ); "
+        "E = normalize( -pos ); "
+        "H = normalize( L + E ); "
+
+        // pass on the material-related variables
+        "shininess = vObjShininess; "
+
+        // convert the vertex to camera coordinates
+        "gl_Position = Projection * modelView * vPosition; "
+        "} "
+        ;
+    const GLchar* fShaderCode =
+        // variables passed from the vertex shader
+        "varying vec3 N,L, E, H; "
+        "varying float shininess; "
+        "varying vec4 colorAmbient, colorDiffuse, colorSpecular; "
+
+        // uniform variables (besides the per-frame ones, above)
+        "uniform float Shininess; "
+        "varying vec4 pickColor; "
+
+        // main fragment shader
+        "void main()  "
+        "{  "
+
+        // if we are picking, use the pick color, ignoring everything else
+        "if (pickColor.a >= 0.0) { "
+        "   gl_FragColor = pickColor; "
+        "   return;"
+        "} "
+
+        // compute color intensities
+        "vec4 AmbientProduct = light_ambient * colorAmbient; "
+        "vec4 DiffuseProduct = light_diffuse * colorDiffuse; "
+        "vec4 SpecularProduct = light_specular * colorSpecular; "
+
+        // Compute fragment colors based on illumination equations
+        "vec4 ambient = AmbientProduct; "
+        "float Kd = max( dot(L, N), 0.0 ); "
+        "vec4  diffuse = Kd*DiffuseProduct; "
+        "float Ks = pow( max(dot(N, H), 0.0), shininess ); "
+        "vec4  specular = Ks * SpecularProduct; "
+        "if( dot(L, N) < 0.0 ) { "
+        "  specular = vec4(0.0, 0.0, 0.0, 1.0); } "
+
+        // add the color components
+        "  gl_FragColor = ambient + specular + diffuse; "
+        "}  "
+        ;
+
+    // set up the GLSL shaders
+    GLuint program = InitShader2((header + vShaderCode).c_str(),
+                                 (header + fShaderCode).c_str());
+    if (frameBlock) {
+        glUniformBlockBinding(program, glGetUniformBlockIndex(program, "Frame"),
+                              FRAME_BINDING);
+    }
+
+    // set up vertex arrays
+    setVertexAttributes(program);
+
+    // and a second set, for the streamed dice: room for three frames' worth
+    glGenVertexArrays(1, &streamVao);
+    stateBindVertexArray(streamVao);
+    if (!diceStream.init(NUM_DICE * cubeVertexCount() * sizeof(Vertex))) {
+        std::cerr << "could not create the dice's vertex buffer" << std::endl;
+        exit(1);
+    }
+    stateBindBuffer(GL_ARRAY_BUFFER, diceStream.buffer());
+    setVertexAttributes(program);
+
+    // and a third, for instanced dice: the static vertices, plus attributes
+    // that advance once per instance
+    instancingAvailable = glVersionAtLeast(3, 3) ||
+        (glVersionAtLeast(3, 1) && glHasExtension("GL_ARB_instanced_arrays"));
+    vInstanceModelView = glGetAttribLocation(program, "vInstanceModelView");
+    vInstanceColor = glGetAttribLocation(program, "vInstanceColor");
+    vInstancePick = glGetAttribLocation(program, "vInstancePick");
+    Instanced = glGetUniformLocation(program, "Instanced");
+    if (vInstanceModelView < 0 ||
+        !instanceStream.init(MAX_INSTANCES * sizeof(DiceInstance))) {
+        instancingAvailable = false;
+    }
+    if (instancingAvailable) {
+        glGenVertexArrays(1, &instancedVao);
+        stateBindVertexArray(instancedVao);
+        stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+        setVertexAttributes(program);
+        GLint locations[] = { vInstanceModelView, vInstanceModelView + 1,
+            vInstanceModelView + 2, vInstanceModelView + 3,
+            vInstanceColor, vInstancePick };
+        for (size_t i = 0; i < sizeof(locations) / sizeof(*locations); i++) {
+            if (locations[i] < 0) continue;
+            stateEnableVertexAttribArray(locations[i]);
+            glVertexAttribDivisor(locations[i], 1);
+        }
+        setInstanceAttributes(0);
+    }
+    instancing = instancingAvailable;
+    stateBindVertexArray(staticVao);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+    // Initialize lighting intensities (with a frame block, they go with
+    // each frame's constants)
+    if (!frameBlock) {
+        stateUniform4fv(glGetUniformLocation(program, "light_ambient"), LIGHT_AMBIENT);
+        stateUniform4fv(glGetUniformLocation(program, "light_diffuse"), LIGHT_DIFFUSE);
+        stateUniform4fv(glGetUniformLocation(program, "light_specular"), LIGHT_SPECULAR);
+    }
+
+    lightId = glGetUniformLocation(program, "LightPosition");
+
+    // initialize picking
+    setGpuPickColorId(glGetUniformLocation(program, "PickColor"));
+
+    // Retrieve transformation uniform variable locations
+    ModelViewStart = glGetUniformLocation(program, "ModelViewStart");
+    ModelView = glGetUniformLocation(program, "ModelView");
+    Projection = glGetUniformLocation(program, "Projection");
+
+    // enable z-buffer algorithm
+    stateEnable(GL_DEPTH_TEST);
+
+    // set background color to be white
+    stateClearColor(1.0, 1.0, 1.0, 1.0);
+}
+
@@ -0,0 +1,88 @@
+/*
+ * Scene code for the Pig dice game: the geometry, the shaders, and the
+ * drawing of one frame from a snapshot of the game state.
+ *
+ * Drawing is split in two: sceneBuild() turns a snapshot into a list of
+ * objects with their model-view matrices (no OpenGL involved), leaving out
+ * those outside the view frustum, and sceneSubmit() sends that list to
+ * the GPU.  Neither changes the game, so
+ * a frame can be drawn any number of times, e.g., once more for picking.
+ */
+
+#ifndef __SCENE_H__
+#define __SCENE_H__
+
+#include "cs432.h"
+#include "mat.h"
+#include "game.h"
+#include "cull.h"
+#include "lod.h"
+#include <vector>
+
+// one object to draw: where it goes, which vertices, and its pick-id
+// (0 if it cannot be picked).  For the dice, 'dice' says which one it is
+// (it is -1 for everything else); the dice are either instanced or drawn
+// from vertices generated afresh each frame, in which case 'start' counts
+// from the first of those.
+struct DrawItem {
+    mat4 modelView;
+    mat4 gpuModelView; // modelView transposed (column by column), as the
+                       // GPU takes it; set for the objects that are drawn
+    int start;
+    int count;
+    int pickId;
+    int dice;
+    vec4 bounds; // bounding sphere in object coordinates: center, radius
+    const LodSet* lod; // levels of detail to choose 'start' and 'count' from,
+                       // or NULL
+    int lodSlot;       // where the object was added to the list
+};
+
+// generate the geometry, send it to the GPU and set up the shaders;
+// requires a current OpenGL context
+void sceneInit(void);
+
+// change the color of one of the dice (from the next frame on)
+void sceneSetDiceColor(int die, const vec4& color);
+
+// draw the dice with one instanced draw call (on by default, where the
+// driver supports it) or with one draw call each; returns whether
+// instancing is now on
+bool sceneSetInstancing(bool on);
+
+// set the viewport and projection for a window of the given size
+void sceneResize(int width, int height);
+
+// build the list of objects to draw for the given state and camera,
+// leaving out (if culling is on) those that cannot be seen; if 'stats' is
+// given, the objects tested and culled are added to it
+void sceneBuild(const GameSnapshot& snap, const mat4& camera,
+                std::vector<DrawItem>& items, CullStats* stats = NULL);
+
+// turn view-frustum culling on or off (it is on by default); returns
+// whether it is now on
+bool sceneSetCulling(bool on);
+
+// where the time in sceneSubmit() went, in seconds
+struct SubmitTimes {
+    double upload; // uniform uploads (matrices, light, pick colors)
+    double draw;   // draw calls
+};
+
+// clear the frame and draw the objects in the list; if 'times' is given,
+// the time spent is added to it
+void sceneSubmit(const GameSnapshot& snap, const mat4& camera,
+                 const std::vector<DrawItem>& items, SubmitTimes* times = NULL);
+
+// what the last sceneSubmit() asked the GPU to draw
+struct DrawStats {
+    int drawCalls;
+    long triangles;
+};
+const DrawStats& sceneDrawStats(void);
+
+// build and submit in one go
+void sceneRender(const GameSnapshot& snap, const mat4& camera,
+                 CullStats* stats = NULL);
+
+#endif
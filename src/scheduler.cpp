@@ -0,0 +1,57 @@
+/*
+ * Scheduler code; runs callbacks after a delay, without blocking.
+ */
+
+#include "scheduler.h"
+#include <algorithm>
+
+// constructor
+Scheduler::Scheduler(): _now(0), _nextSeq(0), _nextId(1)
+{ }
+
+// heap ordering: the event that should run first compares greatest
+bool Scheduler::later(const Event& a, const Event& b) {
+    if (a.time != b.time) return a.time > b.time;
+    return a.seq > b.seq;
+}
+
+int Scheduler::after(double delay, scheduledFunction* fcn, void* data, int value) {
+    Event e;
+    e.time = _now + (delay > 0 ? delay : 0);
+    e.seq = _nextSeq++;
+    e.id = _nextId++;
+    e.fcn = fcn;
+    e.data = data;
+    e.value = value;
+    _events.push_back(e);
+    std::push_heap(_events.begin(), _events.end(), later);
+    return e.id;
+}
+
+bool Scheduler::cancel(int id) {
+    for (size_t i = 0; i < _events.size(); i++) {
+        if (_events[i].id == id) {
+            _events.erase(_events.begin() + i);
+            std::make_heap(_events.begin(), _events.end(), later);
+            return true;
+        }
+    }
+    return false;
+}
+
+// run due events one at a time, so that a callback may safely schedule
+// (or cancel) further events; an event scheduled with no delay from inside
+// a callback runs during this same call
+void Scheduler::advance(double dt) {
+    _now += dt;
+    while (!_events.empty() && _events.front().time <= _now) {
+        std::pop_heap(_events.begin(), _events.end(), later);
+        Event e = _events.back();
+        _events.pop_back();
+        e.fcn(e.data, e.value);
+    }
+}
+
+void Scheduler::clear(void) {
+    _events.clear();
+}
@@ -0,0 +1,58 @@
+/*
+ * Scheduler code; runs callbacks after a delay, without blocking.
+ *
+ * The scheduler keeps its own notion of time, which moves forward only when
+ * advance() is called.  The main program advances it once per simulation
+ * step, so a delay such as "show the result for half a second" becomes a
+ * pending event rather than a pause of the render thread.
+ */
+
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <cstddef>
+#include <vector>
+
+// callback type: 'data' and 'value' are whatever was given when scheduling
+typedef void scheduledFunction(void* data, int value);
+
+// class definition
+class Scheduler {
+    struct Event {
+        double time;             // when the event comes due
+        long seq;                // tie-breaker: earlier-scheduled runs first
+        int id;                  // handle returned to the caller
+        scheduledFunction* fcn;
+        void* data;
+        int value;
+    };
+
+    std::vector<Event> _events; // binary heap, soonest event at the front
+    double _now;                // current scheduler time, in seconds
+    long _nextSeq;
+    int _nextId;
+
+    static bool later(const Event& a, const Event& b);
+
+public:
+    // constructor
+    Scheduler();
+
+    // call fcn(data, value) once 'delay' seconds have elapsed; returns an
+    // id that can be passed to cancel()
+    int after(double delay, scheduledFunction* fcn, void* data = NULL, int value = 0);
+
+    // remove a pending event; returns false if it has already run
+    bool cancel(int id);
+
+    // move time forward, running (in time order) every event that comes due
+    void advance(double dt);
+
+    // drop all pending events
+    void clear(void);
+
+    double now(void) const { return _now; }
+    bool pending(void) const { return !_events.empty(); }
+};
+
+#endif
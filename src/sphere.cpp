@@ -1,7 +1,6 @@
 // Sphere approximation by recursive subdivision of a tetrahedron, adapted from
 // code in Angel, 6th edition.
 
-#include "cs432.h"
 #include "vec.h"
 #include "sphere.h"
 
@@ -28,90 +27,71 @@ static point4 unit(const point4 &p) {
 }
 
 static void triangle(point4  a, point4 b, point4 c, color4 color,
-			  int* idxSpot, point4* pointArray, color4* colorArray,
-				vec3* normalArray, bool flatShading) {
-	if (idxSpot[0]+3 > idxSpot[1]) {
-		*idxSpot += 3;
+			  Mesh& mesh, bool flatShading) {
+	if (flatShading) {
+		vec3 flatNormal = normalize(cross(b-a,b-c));
+		mesh.add(a, flatNormal, color, 0);
+		mesh.add(b, flatNormal, color, 0);
+		mesh.add(c, flatNormal, color, 0);
 	}
 	else {
-		if (pointArray != NULL) pointArray[*idxSpot]= a;
-		if (colorArray != NULL) colorArray[*idxSpot] = color;
-		vec3 flatNormal;
-		if (normalArray != NULL) {
-			if (flatShading) {
-				flatNormal = normalize(cross(b-a,b-c));
-				normalArray[*idxSpot] = flatNormal;
-			}
-			else {
-				vec4 nma = normalize(a);
-				normalArray[*idxSpot] = vec3(nma.x,nma.y,nma.z);
-			}
-		}
-		++*idxSpot;
-		if (pointArray != NULL) pointArray[*idxSpot] = b;
-		if (colorArray != NULL) colorArray[*idxSpot] = color;
-		if (normalArray != NULL) {
-			if (flatShading) {
-				normalArray[*idxSpot] = flatNormal;	
-			}
-			else {
-				vec4 nmb = normalize(b);
-				normalArray[*idxSpot] = vec3(nmb.x,nmb.y,nmb.z);
-			}
-		}
-		
-		++*idxSpot;
-		if (pointArray != NULL) pointArray[*idxSpot] = c;
-		if (colorArray != NULL) colorArray[*idxSpot] = color;
-		if (normalArray != NULL) {
-			if (flatShading) {
-				normalArray[*idxSpot] = flatNormal;
-			}
-			else {
-				vec4 nmc = normalize(c);
-				normalArray[*idxSpot] = vec3(nmc.x,nmc.y,nmc.z);
-			}
-		}
-		++*idxSpot;
+		vec4 nma = normalize(a);
+		mesh.add(a, vec3(nma.x,nma.y,nma.z), color, 0);
+		vec4 nmb = normalize(b);
+		mesh.add(b, vec3(nmb.x,nmb.y,nmb.z), color, 0);
+		vec4 nmc = normalize(c);
+		mesh.add(c, vec3(nmc.x,nmc.y,nmc.z), color, 0);
 	}
 }
 
 
 static void divide_triangle(point4 a, point4 b, point4 c, color4 color, int n,
-							int* idxSpot, point4* pointArray, color4* colorArray,
-							vec3* normalArray, bool flatShading = false) {
+							Mesh& mesh, bool flatShading = false) {
 	point4 v1, v2, v3;
 	if(n>0) {
 		v1 = unit(a + b);
 		v2 = unit(a + c);
 		v3 = unit(b + c);   
-		divide_triangle(a ,v2, v1, color, n-1, idxSpot, pointArray, colorArray, normalArray, flatShading);
-		divide_triangle(c ,v3, v2, color, n-1, idxSpot, pointArray, colorArray, normalArray, flatShading);
-		divide_triangle(b ,v1, v3, color, n-1, idxSpot, pointArray, colorArray, normalArray, flatShading);
-		divide_triangle(v1 ,v2, v3, color, n-1, idxSpot, pointArray, colorArray, normalArray, flatShading);
+		divide_triangle(a ,v2, v1, color, n-1, mesh, flatShading);
+		divide_triangle(c ,v3, v2, color, n-1, mesh, flatShading);
+		divide_triangle(b ,v1, v3, color, n-1, mesh, flatShading);
+		divide_triangle(v1 ,v2, v3, color, n-1, mesh, flatShading);
 	}
 	else {
-		triangle(a, c, b, color, idxSpot, pointArray, colorArray, normalArray, flatShading);
+		triangle(a, c, b, color, mesh, flatShading);
 	}
 }
 
-ObjRef genSphere(color4 color, int n, int* idxSpot,
-					   point4* pointArray, color4* colorArray, vec3* normalArray) {
-	int startIdx = *idxSpot;
-	divide_triangle(v[0], v[1], v[2], color, n, idxSpot, pointArray, colorArray, normalArray);
-	divide_triangle(v[3], v[2], v[1], color, n, idxSpot, pointArray, colorArray, normalArray);
-	divide_triangle(v[0], v[3], v[1], color, n, idxSpot, pointArray, colorArray, normalArray);
-	divide_triangle(v[0], v[2], v[3], color, n, idxSpot, pointArray, colorArray, normalArray);
-	return ObjRef(startIdx, *idxSpot);
+// each of the tetrahedron's 4 faces becomes 4^n triangles
+int sphereVertexCount(int n) {
+	return 4 * 3 * (1 << (2 * n));
 }
 
-ObjRef genFlatSphere(color4 color, int n, int* idxSpot,
-				 point4* pointArray, color4* colorArray, vec3* normalArray) {
-	int startIdx = *idxSpot;
-	divide_triangle(v[0], v[1], v[2], color, n, idxSpot, pointArray, colorArray, normalArray, true);
-	divide_triangle(v[3], v[2], v[1], color, n, idxSpot, pointArray, colorArray, normalArray, true);
-	divide_triangle(v[0], v[3], v[1], color, n, idxSpot, pointArray, colorArray, normalArray, true);
-	divide_triangle(v[0], v[2], v[3], color, n, idxSpot, pointArray, colorArray, normalArray, true);
-	return ObjRef(startIdx, *idxSpot);
+ObjRef genSphere(Mesh& mesh, color4 color, int n) {
+	int startIdx = mesh.size();
+	divide_triangle(v[0], v[1], v[2], color, n, mesh);
+	divide_triangle(v[3], v[2], v[1], color, n, mesh);
+	divide_triangle(v[0], v[3], v[1], color, n, mesh);
+	divide_triangle(v[0], v[2], v[3], color, n, mesh);
+	return mesh.objectFrom(startIdx);
 }
 
+// each level has a quarter of the triangles of the one before, with edges
+// twice as long, so it suits objects half the size
+LodSet genSphereLods(Mesh& mesh, color4 color, int n, int levels,
+					 GLfloat fullDetailSize) {
+	LodSet lods;
+	for (int i = 0; i < levels && i <= n && i < LodSet::MAX_LEVELS; i++) {
+		lods.add(genSphere(mesh, color, n - i), fullDetailSize / (1 << i));
+	}
+	return lods;
+}
+
+ObjRef genFlatSphere(Mesh& mesh, color4 color, int n) {
+	int startIdx = mesh.size();
+	divide_triangle(v[0], v[1], v[2], color, n, mesh, true);
+	divide_triangle(v[3], v[2], v[1], color, n, mesh, true);
+	divide_triangle(v[0], v[3], v[1], color, n, mesh, true);
+	divide_triangle(v[0], v[2], v[3], color, n, mesh, true);
+	return mesh.objectFrom(startIdx);
+}
@@ -9,15 +9,25 @@
 #ifndef __SPHERE_H__
 #define __SPHERE_H__
 
-#include "cs432.h"
 #include "vec.h"
+#include "mesh.h"
+#include "lod.h"
 
-extern ObjRef genSphere(vec4 color, int n, int* idxSpot,
-				 vec4* pointArray, vec4* colorArray,
-						vec3* normalArray);
-extern ObjRef genFlatSphere(vec4 color, int n, int* idxSpot,
-							vec4* pointArray, vec4* colorArray,
-							vec3* normalArray);
+// generate a sphere of unit radius, by subdividing each face of a
+// tetrahedron n times, appending its vertices to the mesh
+extern ObjRef genSphere(Mesh& mesh, vec4 color, int n);
+
+// as genSphere, but with a flat normal for each triangle
+extern ObjRef genFlatSphere(Mesh& mesh, vec4 color, int n);
+
+// the number of vertices genSphere or genFlatSphere generates for level n
+extern int sphereVertexCount(int n);
+
+// generate a sphere at several levels of detail, subdivided n times, then
+// n-1 times, and so on; level i is for when the sphere is at least
+// fullDetailSize / 2^i pixels across (the last, for anything smaller)
+extern LodSet genSphereLods(Mesh& mesh, vec4 color, int n, int levels,
+                            GLfloat fullDetailSize);
 
 
 #endif
@@ -0,0 +1,120 @@
+/*
+ * Streaming buffers: GPU buffers for data (vertices, uniform blocks) that
+ * changes every frame.
+ */
+
+#include "streamBuffer.h"
+#include "glState.h"
+
+// whether the driver offers glBufferStorage
+static bool haveBufferStorage(void) {
+    return glVersionAtLeast(4, 4) || glHasExtension("GL_ARB_buffer_storage");
+}
+
+// discard the errors OpenGL has recorded so far, so that the next
+// glGetError() reports only what follows (bounded, as without a context
+// glGetError can keep reporting)
+static void clearGlErrors(void) {
+    for (int i = 0; i < 32 && glGetError() != GL_NO_ERROR; i++) { }
+}
+
+// constructor: no buffer yet
+StreamBuffer::StreamBuffer()
+    : _buffer(0), _regionSize(0), _regions(0), _current(0), _published(-1),
+      _mapped(NULL)
+{
+    for (int i = 0; i < MAX_REGIONS; i++) _fences[i] = 0;
+}
+
+bool StreamBuffer::init(GLsizeiptr regionSize, int regions) {
+    if (regions < 1 || regions > MAX_REGIONS || regionSize <= 0) {
+        std::cerr << "StreamBuffer: bad size" << std::endl;
+        return false;
+    }
+    _regionSize = regionSize;
+    _regions = regions;
+    _current = 0;
+    _published = -1;
+    _mapped = NULL;
+    clearGlErrors();
+
+    glGenBuffers(1, &_buffer);
+    stateBindBuffer(GL_ARRAY_BUFFER, _buffer);
+    GLsizeiptr size = _regionSize * _regions;
+
+    if (haveBufferStorage()) {
+        // immutable storage, mapped once for the life of the buffer
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        _mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (_mapped == NULL) {
+            // the storage is immutable, so glBufferData cannot replace
+            // it: start again with a fresh buffer
+            stateDeleteBuffers(1, &_buffer);
+            clearGlErrors();
+            glGenBuffers(1, &_buffer);
+            stateBindBuffer(GL_ARRAY_BUFFER, _buffer);
+        }
+    }
+    if (_mapped == NULL) {
+        // no persistent mapping: write to the CPU, upload on end()
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+        _staging.resize(_regionSize);
+    }
+    return glGetError() == GL_NO_ERROR;
+}
+
+void StreamBuffer::destroy(void) {
+    if (_buffer == 0) return;
+    for (int i = 0; i < MAX_REGIONS; i++) {
+        if (_fences[i] != 0) glDeleteSync(_fences[i]);
+        _fences[i] = 0;
+    }
+    if (_mapped != NULL) {
+        stateBindBuffer(GL_ARRAY_BUFFER, _buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        _mapped = NULL;
+    }
+    stateDeleteBuffers(1, &_buffer);
+    _buffer = 0;
+    _staging.clear();
+}
+
+void* StreamBuffer::begin(void) {
+    if (_mapped == NULL) return &_staging[0];
+
+    // wait for the GPU to finish with the frame that last used this region;
+    // with three regions that frame is two frames back, so normally the
+    // fence has long since signaled
+    GLsync& fence = _fences[_current];
+    if (fence != 0) {
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (glClientWaitSync(fence, flags, 1000000) == GL_TIMEOUT_EXPIRED) {
+            flags = 0;
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+    return _mapped + _current * _regionSize;
+}
+
+GLintptr StreamBuffer::end(GLsizeiptr used) {
+    GLintptr offset = _current * _regionSize;
+    if (_mapped == NULL) {
+        stateBindBuffer(GL_ARRAY_BUFFER, _buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, used, &_staging[0]);
+    }
+    // (as the mapping is coherent, there is nothing to flush)
+    _published = _current;
+    _current = (_current + 1) % _regions;
+    return offset;
+}
+
+void StreamBuffer::fence(void) {
+    // without a mapping, glBufferSubData is ordered by the driver
+    if (_mapped == NULL || _published < 0) return;
+    GLsync& fence = _fences[_published];
+    if (fence != 0) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _published = -1;
+}
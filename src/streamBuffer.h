@@ -0,0 +1,71 @@
+/*
+ * Streaming buffers: GPU buffers for data (vertices, uniform blocks) that
+ * changes every frame.
+ *
+ * The buffer is divided into a ring of regions (three by default).  Each
+ * frame, begin() hands out the next region for the CPU to write, end()
+ * publishes what was written and returns where it sits in the buffer, and
+ * once the draws that read it have been issued, fence() marks the region
+ * as in use.  Until the GPU passes that fence, the CPU will not write the
+ * region again.
+ *
+ * Where the driver offers immutable buffer storage (OpenGL 4.4, or
+ * ARB_buffer_storage) the buffer is mapped once, persistently and
+ * coherently, so the CPU writes straight into memory the GPU reads, with
+ * no staging copy and no per-frame map/unmap.  Otherwise writes go to a
+ * CPU-side staging area and end() uploads them with glBufferSubData.
+ */
+
+#ifndef __STREAM_BUFFER_H__
+#define __STREAM_BUFFER_H__
+
+#include "cs432.h"
+#include <vector>
+
+class StreamBuffer {
+public:
+    // the most regions a ring can have
+    enum { MAX_REGIONS = 4 };
+
+private:
+    GLuint _buffer;
+    GLsizeiptr _regionSize;     // bytes per region
+    int _regions;               // regions in the ring
+    int _current;               // the region begin() hands out next
+    int _published;             // the region end() last published, or -1
+    GLsync _fences[MAX_REGIONS];
+    unsigned char* _mapped;     // the persistent mapping, if we have one
+    std::vector<unsigned char> _staging; // otherwise, where writes go
+
+public:
+    // constructor: no buffer yet (see init)
+    StreamBuffer();
+
+    // create the buffer, with 'regions' regions of 'regionSize' bytes
+    // each; requires a current OpenGL context.  Returns false (after
+    // printing why) if the buffer could not be created.
+    bool init(GLsizeiptr regionSize, int regions = 3);
+
+    // release the buffer; requires the context it was created in
+    void destroy(void);
+
+    // the next region to write, regionSize() bytes long; waits, if need
+    // be, until the GPU has finished with it
+    void* begin(void);
+
+    // publish the first 'used' bytes of the region from begin(), and move
+    // on to the next region; returns the region's offset in the buffer
+    GLintptr end(GLsizeiptr used);
+
+    // call after issuing the draws that read the region from end(): the
+    // region is not handed out again until the GPU has finished them
+    void fence(void);
+
+    GLuint buffer(void) const { return _buffer; }
+    GLsizeiptr regionSize(void) const { return _regionSize; }
+
+    // whether writes go straight to GPU-visible memory
+    bool persistent(void) const { return _mapped != NULL; }
+};
+
+#endif
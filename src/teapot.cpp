@@ -2,7 +2,6 @@
 // generates a teapot. Adapatived from code from Edward Angel computer graphics
 // book, 6th edition.
 
-#include "cs432.h"
 #include "teapot.h"
 #include "vec.h"
 
@@ -559,55 +558,17 @@ divide_curve( point4 c[4], point4 r[4], point4 l[4] )
 //----------------------------------------------------------------------------
 
 static void
-draw_patch( point4 p[4][4], color4 color, int* idxSpot,
-		   point4* pointArray, color4* colorArray )
+draw_patch( point4 p[4][4], color4 color, Mesh& mesh )
 {
     // Draw the quad (as two triangles) bounded by the corners of the
     //   Bezier patch.
-#if 0
-    pointArray[*idxSpot] = p[0][0];
-	colorArray[*idxSpot] = color;
-	++*idxSpot;
-    pointArray[*idxSpot] = p[3][0];
-	colorArray[*idxSpot] = color;
-	++*idxSpot;
-    pointArray[*idxSpot] = p[3][3];
-	colorArray[*idxSpot] = color;
-	++*idxSpot;
-    pointArray[*idxSpot] = p[0][0];
-	colorArray[*idxSpot] = color;
-	++*idxSpot;
-    pointArray[*idxSpot] = p[3][3];
-	colorArray[*idxSpot] = color;
-	++*idxSpot;
-    pointArray[*idxSpot] = p[0][3];
-	colorArray[*idxSpot] = color;
-	++*idxSpot; 
-#else
-	if (idxSpot[0]+6 > idxSpot[1]) {
-		*idxSpot += 6;
-	}
-	else {
-		pointArray[*idxSpot] = p[0][0];
-		colorArray[*idxSpot] = color;
-		++*idxSpot;
-		pointArray[*idxSpot] = p[3][0];
-		colorArray[*idxSpot] = color;
-		++*idxSpot;
-		pointArray[*idxSpot] = p[3][3];
-		colorArray[*idxSpot] = color;
-		++*idxSpot;
-		pointArray[*idxSpot] = p[0][0];
-		colorArray[*idxSpot] = color;
-		++*idxSpot;
-		pointArray[*idxSpot] = p[3][3];
-		colorArray[*idxSpot] = color;
-		++*idxSpot;
-		pointArray[*idxSpot] = p[0][3];
-		colorArray[*idxSpot] = color;
-		++*idxSpot; 
-	}
-#endif
+	vec3 normal = normalize(cross(p[3][0] - p[0][0], p[3][3] - p[3][0]));
+	mesh.add(p[0][0], normal, color, 0);
+	mesh.add(p[3][0], normal, color, 0);
+	mesh.add(p[3][3], normal, color, 0);
+	mesh.add(p[0][0], normal, color, 0);
+	mesh.add(p[3][3], normal, color, 0);
+	mesh.add(p[0][3], normal, color, 0);
 }
 
 //----------------------------------------------------------------------------
@@ -625,8 +586,7 @@ transpose( point4 a[4][4] )
 }
 
 static void
-divide_patch( point4 p[4][4], color4 color, int count, int* idxSpot,
-			 point4* pointArray, color4* colorArray )
+divide_patch( point4 p[4][4], color4 color, int count, Mesh& mesh )
 {
     if ( count > 0 ) {
 		point4 q[4][4], r[4][4], s[4][4], t[4][4];
@@ -647,19 +607,23 @@ divide_patch( point4 p[4][4], color4 color, int count, int* idxSpot,
         }
 		
 		// recursive division of 4 resulting patches
-        divide_patch(q, color, count - 1, idxSpot, pointArray, colorArray);
-        divide_patch(r, color, count - 1, idxSpot, pointArray, colorArray);
-        divide_patch(s, color, count - 1, idxSpot, pointArray, colorArray);
-        divide_patch(t, color, count - 1, idxSpot, pointArray, colorArray);
+        divide_patch(q, color, count - 1, mesh);
+        divide_patch(r, color, count - 1, mesh);
+        divide_patch(s, color, count - 1, mesh);
+        divide_patch(t, color, count - 1, mesh);
     }
     else {
-        draw_patch(p, color, idxSpot, pointArray, colorArray);
+        draw_patch(p, color, mesh);
     }
 }
 
-ObjRef genHalfTeapot(color4 color, int n, int* idxSpot,
-				 point4* pointArray, color4* colorArray) {
-	int startIdx = *idxSpot;
+// each patch becomes 4^n quads, of 2 triangles each
+int halfTeapotVertexCount(int n) {
+	return NumTeapotPatches * (1 << (2 * n)) * 6;
+}
+
+ObjRef genHalfTeapot(Mesh& mesh, color4 color, int n) {
+	int startIdx = mesh.size();
 	
 	for ( int k = 0; k < NumTeapotPatches; k++ ) {
 		point4  patch[4][4];
@@ -673,9 +637,18 @@ ObjRef genHalfTeapot(color4 color, int n, int* idxSpot,
 		}
 		
 		// Subdivide the patch
-		divide_patch( patch, color, n, idxSpot, pointArray, colorArray);
+		divide_patch( patch, color, n, mesh );
 	}
 	
-	return ObjRef(startIdx, min(idxSpot[0],idxSpot[1]));
+	return mesh.objectFrom(startIdx);
+}
+
+LodSet genHalfTeapotLods(Mesh& mesh, color4 color, int n, int levels,
+						 GLfloat fullDetailSize) {
+	LodSet lods;
+	for (int i = 0; i < levels && i <= n && i < LodSet::MAX_LEVELS; i++) {
+		lods.add(genHalfTeapot(mesh, color, n - i), fullDetailSize / (1 << i));
+	}
+	return lods;
 }
 #endif
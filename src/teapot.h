@@ -2,10 +2,25 @@
 #define __TEAPOT_H__
 
 #include "vec.h"
+#include "mesh.h"
+#include "lod.h"
 typedef vec4 point4;
 typedef vec4 color4;
 
-extern ObjRef genHalfTeapot(color4 color, int n, int* idxSpot,
-						point4* pointArray, color4* colorArray);
+// NOTE: the body of teapot.cpp is compiled out (#if 0), so none
+// of these is defined: they are unavailable until it is enabled
+
+// generate half of the Utah teapot, subdividing each Bezier patch n times
+extern ObjRef genHalfTeapot(Mesh& mesh, color4 color, int n);
+
+// the number of vertices genHalfTeapot generates for level n
+extern int halfTeapotVertexCount(int n);
+
+// generate half of the teapot at several levels of detail, its patches
+// subdivided n times, then n-1 times, and so on; level i is for when the
+// teapot is at least fullDetailSize / 2^i pixels across (the last, for
+// anything smaller)
+extern LodSet genHalfTeapotLods(Mesh& mesh, color4 color, int n, int levels,
+                                GLfloat fullDetailSize);
 
 #endif
@@ -5,7 +5,6 @@
  * 23 August 2014 by Steven R. Vegdahl.
  */
 
-#include "cs432.h"
 #include "vec.h"
 
 //////////////////////////////////////////////////////////////////////////////
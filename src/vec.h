@@ -13,6 +13,11 @@
 
 typedef float GLfloat;
 
+//  Defined constant for when numbers are too small to be used in the
+//    denominator of a division operation.  This is only used if the
+//    DEBUG macro is defined.
+const GLfloat  DivideByZeroTolerance = GLfloat(1.0e-07);
+
 //////////////////////////////////////////////////////////////////////////////
 //
 //  vec2 - 2D vector